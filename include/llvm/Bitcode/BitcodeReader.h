@@ -92,7 +92,9 @@ class Module;
     StringRef getModuleIdentifier() const { return ModuleIdentifier; }
 
     /// Read the bitcode module and prepare for lazy deserialization of function
-    /// bodies. If ShouldLazyLoadMetadata is true, lazily load metadata as well.
+    /// bodies. If ShouldLazyLoadMetadata is true, lazily load metadata as well:
+    /// when the module has a metadata index, only the named metadata and the
+    /// metadata reachable from materialized values are ever decoded.
     /// If IsImporting is true, this module is being parsed for ThinLTO
     /// importing into another module.
     Expected<std::unique_ptr<Module>> getLazyModule(LLVMContext &Context,
@@ -106,6 +108,11 @@ class Module;
     /// compile with ThinLTO, and whether it has a summary.
     Expected<BitcodeLTOInfo> getLTOInfo();
 
+    /// Returns the module hash (see -module-hash), or an all-zero hash if the
+    /// module doesn't have one. This only scans the records of the module
+    /// block, skipping every nested block.
+    Expected<ModuleHash> getModuleHash();
+
     /// Parse the specified bitcode buffer, returning the module summary index.
     Expected<std::unique_ptr<ModuleSummaryIndex>> getSummary();
 
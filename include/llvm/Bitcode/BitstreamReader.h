@@ -257,6 +257,55 @@ public:
     }
   }
 
+  /// Read \p NumElts VBRs with chunks of \p NumBits bits, appending them to
+  /// \p Vals. This is equivalent to calling ReadVBR64 \p NumElts times, but
+  /// values that fit in a single chunk, which are most of them, are peeled
+  /// off CurWord several at a time instead of going through Read.
+  void readVBR64Array(unsigned NumBits, size_t NumElts,
+                      SmallVectorImpl<uint64_t> &Vals) {
+    assert(NumBits && NumBits <= MaxChunkSize && "Invalid VBR chunk size");
+
+    // Every value takes at least one chunk, so a bogus count can't make us
+    // reserve more than the rest of the stream could hold.
+    uint64_t BitsLeft =
+        uint64_t(BitcodeBytes.size() - NextChar) * CHAR_BIT + BitsInCurWord;
+    Vals.reserve(Vals.size() + std::min<uint64_t>(NumElts, BitsLeft / NumBits));
+
+    if (NumBits < 2 || NumBits >= MaxChunkSize) {
+      for (; NumElts; --NumElts)
+        Vals.push_back(ReadVBR64(NumBits));
+      return;
+    }
+
+    // The continuation bits of all the chunks that fit in a word.
+    const word_t ChunkMask = (word_t(1) << (NumBits - 1)) - 1;
+    word_t ContBits = 0;
+    for (unsigned Bit = NumBits - 1; Bit < MaxChunkSize; Bit += NumBits)
+      ContBits |= word_t(1) << Bit;
+
+    while (NumElts) {
+      // The chunks of CurWord up to the first one with its continuation bit
+      // set are complete values.
+      size_t Chunks = std::min<size_t>(BitsInCurWord / NumBits, NumElts);
+      word_t Cont = CurWord & ContBits;
+      size_t Simple =
+          Cont ? std::min<size_t>(countTrailingZeros(Cont) / NumBits, Chunks)
+               : Chunks;
+      for (size_t I = 0; I != Simple; ++I) {
+        Vals.push_back(CurWord & ChunkMask);
+        CurWord >>= NumBits;
+      }
+      BitsInCurWord -= Simple * NumBits;
+      NumElts -= Simple;
+      if (!NumElts)
+        break;
+
+      // The next value has several chunks, or crosses into the next word.
+      Vals.push_back(ReadVBR64(NumBits));
+      --NumElts;
+    }
+  }
+
   void SkipToFourByteBoundary() {
     // If word_t is 64-bits and if we've read less than 32 bits, just dump
     // the bits we have up to the next 32-bit boundary.
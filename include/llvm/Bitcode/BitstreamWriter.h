@@ -248,6 +248,23 @@ public:
     BlockScope.pop_back();
   }
 
+  /// EmitEncodedBlock - Emit a block whose contents were encoded by another
+  /// BitstreamWriter, e.g. on another thread. \p Contents holds everything
+  /// that writer emitted after the block size word of its
+  /// EnterSubblock(BlockID, CodeLen), up to the end of the matching
+  /// ExitBlock(). The contents of a block are word-aligned relative to its
+  /// size word, so only the header needs encoding at the current position.
+  void EmitEncodedBlock(unsigned BlockID, unsigned CodeLen,
+                        ArrayRef<char> Contents) {
+    assert((Contents.size() & 3) == 0 && "Block contents not 32-bit aligned");
+    EmitCode(bitc::ENTER_SUBBLOCK);
+    EmitVBR(BlockID, bitc::BlockIDWidth);
+    EmitVBR(CodeLen, bitc::CodeLenWidth);
+    FlushToWord();
+    Emit(Contents.size() / 4, bitc::BlockSizeWidth);
+    Out.append(Contents.begin(), Contents.end());
+  }
+
   //===--------------------------------------------------------------------===//
   // Record Emission
   //===--------------------------------------------------------------------===//
@@ -530,6 +547,13 @@ private:
 
 public:
 
+  /// InheritBlockInfo - Make the abbreviations that \p Other defined in its
+  /// BLOCKINFO_BLOCK available to the blocks entered in this stream, without
+  /// emitting them. Used to encode blocks for EmitEncodedBlock.
+  void InheritBlockInfo(const BitstreamWriter &Other) {
+    BlockInfoRecords = Other.BlockInfoRecords;
+  }
+
   /// EmitBlockInfoAbbrev - Emit a DEFINE_ABBREV record for the specified
   /// BlockID.
   unsigned EmitBlockInfoAbbrev(unsigned BlockID, std::shared_ptr<BitCodeAbbrev> Abbv) {
@@ -40,6 +40,7 @@
 namespace llvm {
 
 extern cl::opt<bool> UseSegmentSetForPhysRegs;
+extern cl::opt<bool> VerifyLivenessUpdates;
 
 class BitVector;
 class LiveRangeCalc;
@@ -304,12 +305,40 @@ class VirtRegMap;
     void addKillFlags(const VirtRegMap*);
 
     /// Call this method to notify LiveIntervals that instruction \p MI has been
-    /// moved within a basic block. This will update the live intervals for all
-    /// operands of \p MI. Moves between basic blocks are not supported.
+    /// moved. This will update the live intervals for all operands of \p MI.
+    /// Moves within a basic block update the live ranges in place. After a
+    /// move to another basic block, the live intervals of the operands of
+    /// \p MI are recomputed, and their kill flags are cleared.
     ///
     /// \param UpdateFlags Update live intervals for nonallocatable physregs.
     void handleMove(MachineInstr &MI, bool UpdateFlags = false);
 
+    /// Call this method to notify LiveIntervals that instruction \p MI has
+    /// been inserted. \p MI is given a SlotIndex, and the live intervals of
+    /// the registers it reads or writes are recomputed. Returns the index.
+    SlotIndex handleInsert(MachineInstr &MI);
+
+    /// Erase instruction \p MI from its basic block, and recompute the live
+    /// intervals of the registers it read or wrote. Intervals left with
+    /// several connected components are not split, see
+    /// splitSeparateComponents().
+    void eraseInstr(MachineInstr &MI);
+
+    /// Recompute the live intervals of the virtual registers in \p Regs, and
+    /// the cached live ranges of the units of the physical registers in
+    /// \p Regs, from their current defs and uses. Intervals are updated in
+    /// place, so references to them stay valid. The cost is proportional to
+    /// the number of defs and uses of \p Regs, not to the size of the
+    /// function.
+    void recomputeIntervals(ArrayRef<unsigned> Regs);
+
+    /// Check the live intervals of all virtual registers, and all cached live
+    /// ranges of register units, against a computation from scratch. Report a
+    /// fatal error naming \p Banner on the first difference. Passes that
+    /// update LiveIntervals incrementally call this when
+    /// -verify-liveness-updates is given.
+    void verifyIntervals(const char *Banner);
+
     /// Update intervals for operands of \p MI so that they begin/end on the
     /// SlotIndex for \p BundleStart.
     ///
@@ -462,6 +491,25 @@ class VirtRegMap;
     void computeRegUnitRange(LiveRange&, unsigned Unit);
     void computeVirtRegInterval(LiveInterval&);
 
+    /// Compute the live range of register unit \p Unit into the empty range
+    /// \p LR, including the live-in values of ABI blocks.
+    void computeRegUnitRangeWithLiveIns(LiveRange &LR, unsigned Unit);
+
+    /// Move \p MI, which has been spliced into another basic block, to its
+    /// new SlotIndex and recompute the live intervals of its operands.
+    void handleMoveAcrossBlocks(MachineInstr &MI);
+
+    /// Add or remove the RegMaskSlots entries of the register mask operands
+    /// of \p MI, which must have a SlotIndex.
+    void insertRegMaskSlots(const MachineInstr &MI);
+    void removeRegMaskSlots(const MachineInstr &MI);
+
+    /// Check the live intervals of \p Regs against a computation from
+    /// scratch, see verifyIntervals().
+    void verifyRegs(ArrayRef<unsigned> Regs, const char *Banner);
+    void verifyVirtRegInterval(unsigned Reg, const char *Banner);
+    void verifyRegUnitRange(unsigned Unit, const char *Banner);
+
 
     /// Helper function for repairIntervalsInRange(), walks backwards and
     /// creates/modifies live segments in \p LR to match the operands found.
@@ -29,6 +29,7 @@
 #include "llvm/ADT/iterator.h"
 #include "llvm/Analysis/EHPersonalities.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
+#include "llvm/CodeGen/MachineFunctionPool.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineMemOperand.h"
 #include "llvm/IR/DebugLoc.h"
@@ -100,9 +101,9 @@ struct MachineFunctionInfo {
   /// supplied allocator.
   ///
   /// This function can be overridden in a derive class.
-  template<typename Ty>
-  static Ty *create(BumpPtrAllocator &Allocator, MachineFunction &MF) {
-    return new (Allocator.Allocate<Ty>()) Ty(MF);
+  template<typename Ty, typename AllocatorTy>
+  static Ty *create(AllocatorTy &Allocator, MachineFunction &MF) {
+    return new (Allocator.template Allocate<Ty>()) Ty(MF);
   }
 };
 
@@ -254,8 +255,9 @@ class MachineFunction {
   // numbered and this vector keeps track of the mapping from ID's to MBB's.
   std::vector<MachineBasicBlock*> MBBNumbering;
 
-  // Pool-allocate MachineFunction-lifetime and IR objects.
-  BumpPtrAllocator Allocator;
+  // Pool-allocate MachineFunction-lifetime and IR objects. The slabs come
+  // from, and go back to, the MachineFunctionPool of the module.
+  MachineFunctionAllocator Allocator;
 
   // Allocation management for instructions in function.
   Recycler<MachineInstr> InstructionRecycler;
@@ -0,0 +1,105 @@
+//===- llvm/CodeGen/MachineFunctionPool.h -----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Memory that the MachineFunctions of a module pass on to the ones created
+// after them. When a MachineFunction is destroyed, the slabs of its allocator
+// and its MachineRegisterInfo go back to the pool owned by the
+// MachineModuleInfo, so that compiling many small functions does not go back
+// to malloc for every one of them.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CODEGEN_MACHINEFUNCTIONPOOL_H
+#define LLVM_CODEGEN_MACHINEFUNCTIONPOOL_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace llvm {
+
+class MachineFunction;
+class MachineRegisterInfo;
+
+class MachineFunctionPool {
+public:
+  MachineFunctionPool();
+  MachineFunctionPool(const MachineFunctionPool &) = delete;
+  MachineFunctionPool &operator=(const MachineFunctionPool &) = delete;
+  ~MachineFunctionPool();
+
+  /// Return \p Size bytes of memory, reusing a slab released earlier if one
+  /// of that size is available.
+  void *allocateSlab(size_t Size);
+
+  /// Give back a slab returned by allocateSlab. It is kept for later
+  /// functions unless the pool is full, in which case it is freed.
+  void releaseSlab(const void *Slab, size_t Size);
+
+  /// Return a MachineRegisterInfo for \p MF, reusing the vectors and maps of
+  /// one released earlier if possible.
+  MachineRegisterInfo *createRegInfo(MachineFunction *MF);
+
+  /// Give back a MachineRegisterInfo returned by createRegInfo.
+  void releaseRegInfo(MachineRegisterInfo *MRI);
+
+  /// Free everything the pool holds. Memory still in use by live functions
+  /// is not affected.
+  void clear();
+
+  /// Return the number of bytes of slabs held by the pool.
+  size_t getPooledMemory() const { return PooledMemory; }
+
+private:
+  /// Released slabs, by size.
+  DenseMap<size_t, std::vector<void *>> FreeSlabs;
+  size_t PooledMemory = 0;
+
+  std::vector<std::unique_ptr<MachineRegisterInfo>> FreeRegInfos;
+};
+
+/// The underlying allocator of a MachineFunction's BumpPtrAllocator. It gets
+/// its slabs from a MachineFunctionPool and gives them back when the
+/// function is destroyed.
+class MachineFunctionSlabAllocator
+    : public AllocatorBase<MachineFunctionSlabAllocator> {
+  MachineFunctionPool *Pool;
+
+public:
+  explicit MachineFunctionSlabAllocator(MachineFunctionPool &Pool)
+      : Pool(&Pool) {}
+
+  void Reset() {}
+
+  LLVM_ATTRIBUTE_RETURNS_NONNULL void *Allocate(size_t Size,
+                                                size_t /*Alignment*/) {
+    return Pool->allocateSlab(Size);
+  }
+
+  // Pull in base class overloads.
+  using AllocatorBase<MachineFunctionSlabAllocator>::Allocate;
+
+  void Deallocate(const void *Ptr, size_t Size) {
+    Pool->releaseSlab(Ptr, Size);
+  }
+
+  // Pull in base class overloads.
+  using AllocatorBase<MachineFunctionSlabAllocator>::Deallocate;
+};
+
+/// The allocator of a MachineFunction.
+using MachineFunctionAllocator =
+    BumpPtrAllocatorImpl<MachineFunctionSlabAllocator>;
+
+} // end namespace llvm
+
+#endif // LLVM_CODEGEN_MACHINEFUNCTIONPOOL_H
@@ -34,6 +34,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/PointerIntPair.h"
+#include "llvm/CodeGen/MachineFunctionPool.h"
 #include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCSymbol.h"
 #include "llvm/Pass.h"
@@ -135,6 +136,10 @@ class MachineModuleInfo : public ImmutablePass {
   /// functions.
   bool HasNosplitStack;
 
+  /// Memory that MachineFunctions pass on to the ones created after them.
+  /// It must outlive MachineFunctions.
+  MachineFunctionPool FunctionPool;
+
   /// Maps IR Functions to their corresponding MachineFunctions.
   DenseMap<const Function*, std::unique_ptr<MachineFunction>> MachineFunctions;
   /// Next unique number available for a MachineFunction.
@@ -155,6 +160,8 @@ public:
   const MCContext &getContext() const { return Context; }
   MCContext &getContext() { return Context; }
 
+  MachineFunctionPool &getFunctionPool() { return FunctionPool; }
+
   const Module *getModule() const { return TheModule; }
 
   /// Returns the MachineFunction constructed for the IR function \p F.
@@ -66,7 +66,7 @@ private:
   Delegate *TheDelegate = nullptr;
 
   /// True if subregister liveness is tracked.
-  const bool TracksSubRegLiveness;
+  bool TracksSubRegLiveness;
 
   /// VRegInfo - Information we keep for each virtual register.
   ///
@@ -146,6 +146,11 @@ private:
   /// second element.
   std::vector<std::pair<unsigned, unsigned>> LiveIns;
 
+  /// Make this the empty MachineRegisterInfo of \p NewMF, keeping the memory
+  /// its containers have grown to. Used by MachineFunctionPool.
+  void reset(MachineFunction *NewMF);
+  friend class MachineFunctionPool;
+
 public:
   explicit MachineRegisterInfo(MachineFunction *MF);
   MachineRegisterInfo(const MachineRegisterInfo &) = delete;
@@ -137,7 +137,13 @@ public:
     dump(OS, DumpOpts, DumpOffsets);
   }
 
-  bool verify(raw_ostream &OS, DIDumpOptions DumpOpts = {}) override;
+  bool verify(raw_ostream &OS, DIDumpOptions DumpOpts = {}) override {
+    return verify(OS, DumpOpts, 1);
+  }
+
+  /// Verify the debug info, checking the units on up to \p NumThreads
+  /// threads. The output is the same whatever the number of threads.
+  bool verify(raw_ostream &OS, DIDumpOptions DumpOpts, unsigned NumThreads);
 
   using cu_iterator_range = DWARFUnitSection<DWARFCompileUnit>::iterator_range;
   using tu_iterator_range = DWARFUnitSection<DWARFTypeUnit>::iterator_range;
@@ -208,6 +214,17 @@ public:
   /// Get a DIE given an exact offset.
   DWARFDie getDIEForOffset(uint32_t Offset);
 
+  /// Extract the DIEs of all compile units on up to \p NumThreads threads.
+  /// Afterwards the units, and the DIEs they refer to, may be read from
+  /// several threads at once.
+  void extractCompileUnits(unsigned NumThreads);
+
+  /// Parse the line tables of all compile units on up to \p NumThreads
+  /// threads, so that getLineTableForUnit() finds them cached. Tables that
+  /// fail to parse, or parse with warnings, are not cached, and so report
+  /// their problems on first use just as if this had not been called.
+  void parseLineTables(unsigned NumThreads);
+
   unsigned getMaxVersion() const { return MaxVersion; }
 
   void setMaxVersionIfGreater(unsigned Version) {
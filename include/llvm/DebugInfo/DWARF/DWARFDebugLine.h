@@ -275,6 +275,10 @@ public:
       const DWARFContext &Ctx, const DWARFUnit *U,
       std::function<void(Error)> RecoverableErrorCallback = warn);
 
+  /// Cache \p LT as the line table at \p Offset, unless a table has been
+  /// cached there already. Used to add tables parsed on other threads.
+  void insertLineTable(uint32_t Offset, LineTable LT);
+
   /// Helper to allow for parsing of an entire .debug_line section in sequence.
   class SectionParser {
   public:
@@ -476,6 +476,11 @@ public:
   void getInlinedChainForAddress(uint64_t Address,
                                  SmallVectorImpl<DWARFDie> &InlinedChain);
 
+  /// Appends to \p Boundaries every address at which the inlined chain
+  /// returned by getInlinedChainForAddress may change, looking into the .dwo
+  /// unit if there is one.
+  void getInlinedChainBoundaries(std::vector<uint64_t> &Boundaries);
+
   /// getUnitSection - Return the DWARFUnitSection containing this unit.
   const DWARFUnitSectionBase &getUnitSection() const { return UnitSection; }
 
@@ -535,16 +540,18 @@ public:
     return die_iterator_range(DieArray.begin(), DieArray.end());
   }
 
+  /// extractDIEsIfNeeded - Parses a compile unit and indexes its DIEs if it
+  /// hasn't already been done. Returns the number of DIEs parsed at this call.
+  /// Once the unit DIE has been parsed, the rest of the DIEs of different
+  /// units may be extracted concurrently.
+  size_t extractDIEsIfNeeded(bool CUDieOnly);
+
 private:
   /// Size in bytes of the .debug_info data associated with this compile unit.
   size_t getDebugInfoSize() const {
     return Header.getLength() + 4 - getHeaderSize();
   }
 
-  /// extractDIEsIfNeeded - Parses a compile unit and indexes its DIEs if it
-  /// hasn't already been done. Returns the number of DIEs parsed at this call.
-  size_t extractDIEsIfNeeded(bool CUDieOnly);
-
   /// extractDIEsToVector - Appends all parsed DIEs to a vector.
   void extractDIEsToVector(bool AppendCUDie, bool AppendNonCUDIEs,
                            std::vector<DWARFDebugInfoEntry> &DIEs) const;
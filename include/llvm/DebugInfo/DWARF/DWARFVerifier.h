@@ -91,6 +91,8 @@ private:
   raw_ostream &OS;
   DWARFContext &DCtx;
   DIDumpOptions DumpOpts;
+  /// The number of threads to verify units on.
+  unsigned NumThreads;
   /// A map that tracks all references (converted absolute references) so we
   /// can verify each reference points to a valid DIE and not an offset that
   /// lies between to valid DIEs.
@@ -152,7 +154,7 @@ private:
   ///                  type of the unit DIE.
   ///
   /// \returns true if the content is verified successfully, false otherwise.
-  bool verifyUnitContents(DWARFUnit Unit, uint8_t UnitType = 0);
+  bool verifyUnitContents(DWARFUnit &Unit, uint8_t UnitType = 0);
 
   /// Verify that all Die ranges are valid.
   ///
@@ -268,8 +270,10 @@ private:
 
 public:
   DWARFVerifier(raw_ostream &S, DWARFContext &D,
-                DIDumpOptions DumpOpts = DIDumpOptions::getForSingleDIE())
-      : OS(S), DCtx(D), DumpOpts(std::move(DumpOpts)) {}
+                DIDumpOptions DumpOpts = DIDumpOptions::getForSingleDIE(),
+                unsigned NumThreads = 1)
+      : OS(S), DCtx(D), DumpOpts(std::move(DumpOpts)),
+        NumThreads(NumThreads) {}
   /// Verify the information in any of the following sections, if available:
   /// .debug_abbrev, debug_abbrev.dwo
   ///
@@ -283,7 +287,8 @@ public:
   /// Verify the information in the .debug_info section.
   ///
   /// Any errors are reported to the stream that was this object was
-  /// constructed with.
+  /// constructed with. With more than one thread, the contents of the units
+  /// are verified concurrently, and their errors reported in unit order.
   ///
   /// \returns true if the .debug_info verifies successfully, false otherwise.
   bool handleDebugInfo();
@@ -0,0 +1,108 @@
+//===- AddressIndex.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Header for the address index the symbolizer uses to answer repeated lookups
+// into a module without going back to its debug info.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_DEBUGINFO_SYMBOLIZE_ADDRESSINDEX_H
+#define LLVM_DEBUGINFO_SYMBOLIZE_ADDRESSINDEX_H
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace symbolize {
+
+/// A sorted table from the address ranges of a module to the frames that
+/// symbolizing them gives. The ranges are delimited by every address at which
+/// the answer may change, so the table is built by symbolizing one address
+/// per range, and looking an address up is a binary search. An index can be
+/// saved next to the module and loaded by later processes.
+class AddressIndex {
+public:
+  using InlinedCodeFn = function_ref<DIInliningInfo(uint64_t)>;
+  using CodeFn = function_ref<DILineInfo(uint64_t)>;
+
+  /// Build the index of the ranges delimited by \p Boundaries, which need not
+  /// be sorted or unique. \p SymbolizeInlinedCode is called once per range.
+  /// \p SymbolizeCode is only called for ranges with inlined frames; where
+  /// there is a single frame, it is taken to be the answer for both.
+  static std::unique_ptr<AddressIndex>
+  build(std::vector<uint64_t> Boundaries, InlinedCodeFn SymbolizeInlinedCode,
+        CodeFn SymbolizeCode);
+
+  /// Load an index written by save(). Fails if the file is malformed or was
+  /// saved with a different \p Key.
+  static Expected<std::unique_ptr<AddressIndex>> load(StringRef Path,
+                                                      StringRef Key);
+
+  /// Write the index to \p Path, tagged with \p Key. The file is replaced
+  /// atomically, so that concurrent readers see either the old or the new
+  /// index.
+  Error save(StringRef Path, StringRef Key) const;
+
+  /// Look up \p Address. Return false if it is outside the indexed ranges,
+  /// in which case it must be symbolized from the module.
+  bool lookupInlinedCode(uint64_t Address, DIInliningInfo &Result) const;
+  bool lookupCode(uint64_t Address, DILineInfo &Result) const;
+
+private:
+  AddressIndex() = default;
+
+  struct Frame {
+    uint32_t FunctionName;
+    uint32_t FileName;
+    uint32_t Source;
+    uint32_t Line;
+    uint32_t Column;
+    uint32_t StartLine;
+    uint32_t Discriminator;
+  };
+
+  struct Range {
+    uint64_t Start;
+    // Index of the inlined chain in ChainStarts, or NoRange past the end of
+    // the indexed ranges.
+    uint32_t Chain;
+    // Index of the frame symbolizeCode gives in Frames.
+    uint32_t Code;
+  };
+
+  static const uint32_t NoRange = ~0U;
+  static const uint32_t NoSource = ~0U;
+
+  const Range *findRange(uint64_t Address) const;
+  StringRef getString(uint32_t I) const;
+  DILineInfo getFrame(uint32_t I) const;
+
+  /// String I is StringData[StringOffsets[I], StringOffsets[I + 1]).
+  std::string StringData;
+  std::vector<uint32_t> StringOffsets;
+  std::vector<Frame> Frames;
+  /// Chain I is ChainFrames[ChainStarts[I], ChainStarts[I + 1]), innermost
+  /// frame first.
+  std::vector<uint32_t> ChainFrames;
+  std::vector<uint32_t> ChainStarts;
+  /// Sorted by start address. The last range only marks the end of the one
+  /// before it.
+  std::vector<Range> Ranges;
+};
+
+} // end namespace symbolize
+} // end namespace llvm
+
+#endif // LLVM_DEBUGINFO_SYMBOLIZE_ADDRESSINDEX_H
@@ -15,6 +15,7 @@
 
 #include "llvm/DebugInfo/DIContext.h"
 #include <cstdint>
+#include <vector>
 
 namespace llvm {
 namespace symbolize {
@@ -33,6 +34,14 @@ public:
                                               bool UseSymbolTable) const = 0;
   virtual DIGlobal symbolizeData(uint64_t ModuleOffset) const = 0;
 
+  // Append to Boundaries every address at which the results of symbolizeCode
+  // and symbolizeInlinedCode may change, so that they are the same for all
+  // addresses between two consecutive boundaries. Return false if the module
+  // can't tell, in which case it can't be indexed.
+  virtual bool getCodeBoundaries(std::vector<uint64_t> &Boundaries) const {
+    return false;
+  }
+
   // Return true if this is a 32-bit x86 PE COFF module.
   virtual bool isWin32Module() const = 0;
 
@@ -14,6 +14,7 @@
 #ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 #define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 
+#include "llvm/DebugInfo/Symbolize/AddressIndex.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ObjectFile.h"
@@ -40,6 +41,12 @@ public:
     bool UseSymbolTable : 1;
     bool Demangle : 1;
     bool RelativeAddresses : 1;
+    /// Answer code lookups from an AddressIndex of each module, built on
+    /// first use.
+    bool UseAddressIndex : 1;
+    /// Save the address index of each module next to it, and load it from
+    /// there when it is still up to date.
+    bool PersistAddressIndex : 1;
     std::string DefaultArch;
     std::vector<std::string> DsymHints;
 
@@ -48,6 +55,7 @@ public:
             bool RelativeAddresses = false, std::string DefaultArch = "")
         : PrintFunctions(PrintFunctions), UseSymbolTable(UseSymbolTable),
           Demangle(Demangle), RelativeAddresses(RelativeAddresses),
+          UseAddressIndex(false), PersistAddressIndex(false),
           DefaultArch(std::move(DefaultArch)) {}
   };
 
@@ -83,6 +91,17 @@ private:
   Expected<SymbolizableModule *>
   getOrCreateModuleInfo(const std::string &ModuleName, StringRef DWPName = "");
 
+  /// Returns the address index of a module, loading or building it on first
+  /// use, or nullptr if indexing is disabled or the module can't be indexed.
+  AddressIndex *getOrCreateAddressIndex(const std::string &ModuleName,
+                                        SymbolizableModule *Info,
+                                        StringRef DWPName);
+
+  DILineInfo symbolizeCodeInModule(SymbolizableModule *Info,
+                                   uint64_t ModuleOffset);
+  DIInliningInfo symbolizeInlinedCodeInModule(SymbolizableModule *Info,
+                                              uint64_t ModuleOffset);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
@@ -102,6 +121,9 @@ private:
 
   std::map<std::string, std::unique_ptr<SymbolizableModule>> Modules;
 
+  /// Address index for each module name, or null if it can't be indexed.
+  std::map<std::string, std::unique_ptr<AddressIndex>> AddressIndexes;
+
   /// Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
       ObjectPairForPathArch;
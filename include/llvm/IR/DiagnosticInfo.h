@@ -21,6 +21,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/IR/DebugLoc.h"
+#include "llvm/Remarks/Remark.h"
 #include "llvm/Support/CBindingWrapping.h"
 #include "llvm/Support/YAMLTraits.h"
 #include <algorithm>
@@ -461,6 +462,10 @@ public:
 
   bool isVerbose() const { return IsVerbose; }
 
+  /// Return the remark that describes this diagnostic in remark files. Its
+  /// strings point into the diagnostic.
+  remarks::Remark toRemark() const;
+
   static bool classof(const DiagnosticInfo *DI) {
     return (DI->getKind() >= DK_FirstRemark &&
             DI->getKind() <= DK_LastRemark) ||
@@ -37,6 +37,12 @@ class SMDiagnostic;
 class StringRef;
 class Twine;
 
+namespace remarks {
+
+class BinaryRemarkWriter;
+
+} // end namespace remarks
+
 namespace yaml {
 
 class Output;
@@ -167,6 +173,20 @@ public:
   void enableDebugTypeODRUniquing();
   void disableDebugTypeODRUniquing();
 
+  /// Whether the uniquing tables for types, integer and floating-point
+  /// constants, MDStrings and MDNodes may be used from several threads at
+  /// once. Off by default.
+  ///
+  /// In this mode the constant and MDString tables are sharded, each shard
+  /// with its own lock, and the type tables and MDNode sets are guarded by one
+  /// lock each. Only the creation and lookup of these entities becomes thread
+  /// safe: everything else, in particular mutating IR and metadata, still
+  /// needs external synchronization. Must be enabled before the context is
+  /// shared between threads.
+  bool isConcurrentUniquing() const;
+  void enableConcurrentUniquing();
+  void disableConcurrentUniquing();
+
   using InlineAsmDiagHandlerTy = void (*)(const SMDiagnostic&, void *Context,
                                           unsigned LocCookie);
 
@@ -256,6 +276,18 @@ public:
   /// set, the handler is invoked for each diagnostic message.
   void setDiagnosticsOutputFile(std::unique_ptr<yaml::Output> F);
 
+  /// Return the writer used to save optimization diagnostics in the binary
+  /// remark format. If null, they are not saved in that format.
+  remarks::BinaryRemarkWriter *getDiagnosticsBinaryOutput();
+  /// Set the writer used to save optimization diagnostics in the binary
+  /// remark format, either instead of or as well as the YAML output file.
+  void setDiagnosticsBinaryOutput(
+      std::unique_ptr<remarks::BinaryRemarkWriter> W);
+
+  /// Return true if optimization diagnostics are saved in a file, in any
+  /// format.
+  bool hasDiagnosticsOutput();
+
   /// Get the prefix that should be printed in front of a diagnostic of
   ///        the given \p Severity
   static const char *getDiagnosticMessagePrefix(DiagnosticSeverity Severity);
@@ -1049,6 +1049,14 @@ public:
   void collectDefinedGVSummariesPerModule(
       StringMap<GVSummaryMapTy> &ModuleToDefinedGVSummaries) const;
 
+  /// Remove module \p ModulePath from the index, along with the summaries it
+  /// defines, which are given by \p DefinedGVSummaries as collected by
+  /// collectDefinedGVSummariesPerModule(). ValueInfos stay valid, but may be
+  /// left without any summary. Type identifier summaries and CFI function
+  /// names are not tracked per module and are kept.
+  void removeModule(StringRef ModulePath,
+                    const GVSummaryMapTy &DefinedGVSummaries);
+
   /// Export summary to dot file for GraphViz.
   void exportToDot(raw_ostream& OS) const;
 
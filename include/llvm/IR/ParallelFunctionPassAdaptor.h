@@ -0,0 +1,162 @@
+//===- ParallelFunctionPassAdaptor.h - Parallel function passes -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This header defines a module pass adaptor which, like
+/// ModuleToFunctionPassAdaptor, runs a function pass over every function in a
+/// module, but does so on a pool of threads.
+///
+/// Each worker thread owns its own instance of the function pass, built from a
+/// factory, and its own FunctionAnalysisManager, populated by a registration
+/// callback. The contract for the parallel region is:
+///
+/// * The module and its ModuleAnalysisManager are read-only. Function passes
+///   and analyses may only reach module analyses through the
+///   ModuleAnalysisManagerFunctionProxy, which only hands out results that are
+///   already cached, so nothing is computed or invalidated at the module level
+///   until the parallel region is over. Module analyses that a function
+///   pipeline needs must therefore be computed (e.g. with RequireAnalysisPass)
+///   before the adaptor runs.
+/// * The LLVMContext is switched to concurrent uniquing mode (see
+///   LLVMContext::enableConcurrentUniquing()) for the duration of the region,
+///   so that types, integer and floating-point constants, and metadata may be
+///   created from any thread.
+/// * A function pass must not touch any function other than the one it runs
+///   on, nor add, remove or walk the uses of values shared between functions
+///   (globals, constants and metadata used as values): use lists are not
+///   thread safe. Pipelines made of analyses, verification and passes that
+///   only rewrite function-local values satisfy this; most of the default
+///   scalar optimization pipeline does not yet.
+///
+/// Per-function analysis results computed on the worker threads are dropped
+/// once the function is done. The function's cached results in the outer
+/// FunctionAnalysisManager are only kept if the pass preserved everything:
+/// a pass manager reports all function analyses as preserved once it has
+/// invalidated them in the analysis manager it was given, which here is the
+/// worker's, so anything less than PreservedAnalyses::all() can't be trusted
+/// for the outer one.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_IR_PARALLELFUNCTIONPASSADAPTOR_H
+#define LLVM_IR_PARALLELFUNCTIONPASSADAPTOR_H
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace llvm {
+
+/// Trivial adaptor that maps from a module to its functions and runs a
+/// function pass over them on \c ThreadCount threads.
+///
+/// See the file comment for the restrictions on the function pass.
+template <typename FunctionPassT>
+class ParallelModuleToFunctionPassAdaptor
+    : public PassInfoMixin<ParallelModuleToFunctionPassAdaptor<FunctionPassT>> {
+public:
+  /// Builds the function pass instance used by one worker thread.
+  using PassFactoryT = std::function<FunctionPassT()>;
+
+  /// Registers the function analyses with a worker's analysis manager.
+  using AnalysisRegistrationT = std::function<void(FunctionAnalysisManager &)>;
+
+  ParallelModuleToFunctionPassAdaptor(
+      PassFactoryT CreatePass, AnalysisRegistrationT RegisterAnalyses,
+      unsigned ThreadCount = heavyweight_hardware_concurrency())
+      : CreatePass(std::move(CreatePass)),
+        RegisterAnalyses(std::move(RegisterAnalyses)),
+        ThreadCount(ThreadCount) {}
+
+  /// Runs the function pass across every function in the module.
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM) {
+    FunctionAnalysisManager &FAM =
+        AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+
+    SmallVector<Function *, 16> Worklist;
+    for (Function &F : M)
+      if (!F.isDeclaration())
+        Worklist.push_back(&F);
+
+    std::vector<PreservedAnalyses> FunctionPA(Worklist.size(),
+                                              PreservedAnalyses::all());
+    LLVMContext &Ctx = M.getContext();
+    bool WasConcurrent = Ctx.isConcurrentUniquing();
+    Ctx.enableConcurrentUniquing();
+
+    // Each worker grabs the next unprocessed function, so that one expensive
+    // function doesn't hold up a statically assigned batch.
+    std::atomic<size_t> NextFunction(0);
+    auto Work = [&] {
+      FunctionPassT Pass = CreatePass();
+      FunctionAnalysisManager WorkerFAM;
+      // Give the worker the same read-only view of module analyses as the
+      // serial adaptor has. This takes precedence over any proxy registered
+      // by RegisterAnalyses.
+      WorkerFAM.registerPass(
+          [&] { return ModuleAnalysisManagerFunctionProxy(AM); });
+      RegisterAnalyses(WorkerFAM);
+
+      for (size_t I = NextFunction++; I < Worklist.size(); I = NextFunction++) {
+        Function &F = *Worklist[I];
+        FunctionPA[I] = Pass.run(F, WorkerFAM);
+        // Nothing computed on this thread outlives the function.
+        WorkerFAM.clear(F, F.getName());
+      }
+    };
+
+    unsigned NumWorkers =
+        std::max(1u, std::min<unsigned>(ThreadCount, Worklist.size()));
+    {
+      ThreadPool Pool(NumWorkers);
+      for (unsigned I = 0; I != NumWorkers; ++I)
+        Pool.async(Work);
+      Pool.wait();
+    }
+
+    if (!WasConcurrent)
+      Ctx.disableConcurrentUniquing();
+
+    // Now that we're back to a single thread, handle invalidation in the
+    // outer analysis managers in module order, like the serial adaptor does.
+    PreservedAnalyses PA = PreservedAnalyses::all();
+    for (size_t I = 0, E = Worklist.size(); I != E; ++I) {
+      Function &F = *Worklist[I];
+      if (!FunctionPA[I].areAllPreserved())
+        FAM.clear(F, F.getName());
+      PA.intersect(std::move(FunctionPA[I]));
+    }
+
+    // The FunctionAnalysisManagerModuleProxy is preserved because (we assume)
+    // the function passes we ran didn't add or remove any functions.
+    //
+    // We also preserve all analyses on Functions, because we did all the
+    // invalidation we needed to do above.
+    PA.preserveSet<AllAnalysesOn<Function>>();
+    PA.preserve<FunctionAnalysisManagerModuleProxy>();
+    return PA;
+  }
+
+private:
+  PassFactoryT CreatePass;
+  AnalysisRegistrationT RegisterAnalyses;
+  unsigned ThreadCount;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_IR_PARALLELFUNCTIONPASSADAPTOR_H
@@ -16,6 +16,7 @@
 #define LLVM_LTO_CACHING_H
 
 #include "llvm/LTO/LTO.h"
+#include "llvm/Support/CachePruning.h"
 #include <string>
 
 namespace llvm {
@@ -34,6 +35,15 @@ typedef std::function<void(unsigned Task, std::unique_ptr<MemoryBuffer> MB)>
 Expected<NativeObjectCache> localCache(StringRef CacheDirectoryPath,
                                        AddBufferFn AddBuffer);
 
+/// Create a local file system cache like localCache(), which also keeps an
+/// index of its entries (see CacheIndex). Lookups consult the index instead of
+/// the file system, and every new entry triggers an incremental prune of the
+/// least recently used entries according to \p Policy, whose pruning interval
+/// is ignored. The cache directory can still be pruned with pruneCache().
+Expected<NativeObjectCache> indexedCache(StringRef CacheDirectoryPath,
+                                         AddBufferFn AddBuffer,
+                                         CachePruningPolicy Policy);
+
 } // namespace lto
 } // namespace llvm
 
@@ -52,6 +52,12 @@ struct Config {
   /// Disable entirely the optimizer, including importing for ThinLTO
   bool CodeGenOnly = false;
 
+  /// When regular LTO code generation is split into several partitions, make
+  /// each partition a contiguous run of the module's functions instead of
+  /// hashing symbol names, so linking the partitions in order keeps the
+  /// original function layout.
+  bool SplitCodeGenPreserveOrder = false;
+
   /// If this field is set, the set of passes run in the middle-end optimizer
   /// will be the one specified by the string. Only works with the new pass
   /// manager as the old one doesn't have this ability.
@@ -88,6 +94,14 @@ struct Config {
   /// Statistics output file path.
   std::string StatsFile;
 
+  /// If this field is set, the combined summary index of the ThinLTO modules
+  /// is saved to this file by each link, before any analysis has run on it,
+  /// and loaded again by the next one. Modules with the same module path and
+  /// module hash as in the saved index then reuse their summaries instead of
+  /// having them read from bitcode again. Modules without a module hash are
+  /// always read.
+  std::string IncrementalIndexPath;
+
   bool ShouldDiscardValueNames = true;
   DiagnosticHandlerFunction DiagHandler;
 
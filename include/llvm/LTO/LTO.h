@@ -305,6 +305,21 @@ private:
     ModuleSummaryIndex CombinedIndex;
     MapVector<StringRef, BitcodeModule> ModuleMap;
     DenseMap<GlobalValue::GUID, StringRef> PrevailingModuleForGUID;
+
+    /// Summaries that symbol resolutions turn weak (LinkerRedefined) or
+    /// DSO-local (FinalDefinitionInLinkageUnit). These are only applied by
+    /// run(), so that the index saved for an incremental link doesn't depend on
+    /// the resolutions.
+    std::vector<GlobalValueSummary *> LinkerRedefinedSummaries;
+    std::vector<GlobalValueSummary *> DSOLocalSummaries;
+
+    /// For incremental links (see Config::IncrementalIndexPath), the modules
+    /// of the loaded index that no module of this link has claimed yet, with
+    /// the summaries they define.
+    StringMap<GVSummaryMapTy> PrevModuleSummaries;
+    bool LoadedIncrementalIndex = false;
+    /// Whether the index differs from the one that was loaded.
+    bool IncrementalIndexChanged = false;
   } ThinLTO;
 
   // The global resolution for a particular (mangled) symbol name. This is in
@@ -383,6 +398,9 @@ private:
   Error addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
                    const SymbolResolution *&ResI, const SymbolResolution *ResE);
 
+  Error loadIncrementalIndex();
+  Error saveIncrementalIndex();
+
   Error runRegularLTO(AddStreamFn AddStream);
   Error runThinLTO(AddStreamFn AddStream, NativeObjectCache Cache);
 
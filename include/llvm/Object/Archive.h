@@ -14,6 +14,7 @@
 #ifndef LLVM_OBJECT_ARCHIVE_H
 #define LLVM_OBJECT_ARCHIVE_H
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/iterator_range.h"
@@ -22,6 +23,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
@@ -182,6 +184,8 @@ public:
   };
 
   class Symbol {
+    friend Archive;
+
     const Archive *Parent;
     uint32_t SymbolIndex;
     uint32_t StringIndex; // Extra index to the string.
@@ -260,10 +264,35 @@ public:
   // check if a symbol is in the archive
   Expected<Optional<Child>> findSym(StringRef name) const;
 
+  /// Return the first symbol named \p Name in the symbol table, if any.
+  ///
+  /// Lookups go through a hash index of the symbol table, so they take
+  /// constant time. The index is read from the symbol index member if the
+  /// archive has an up-to-date one. Otherwise the first lookup builds the
+  /// index in memory.
+  Optional<Symbol> findSymbol(StringRef Name) const;
+
+  /// The name of the symbol index member. When present, it directly follows
+  /// the symbol table and is not one of the children of the archive.
+  static const char SymbolIndexName[];
+
+  /// Return the contents of the symbol index member for a symbol table with
+  /// contents \p SymbolTable. \p Symbols gives the symbols in order, as their
+  /// names and the offsets of the names in \p SymbolTable.
+  static std::string
+  buildSymbolIndex(StringRef SymbolTable,
+                   ArrayRef<std::pair<StringRef, uint32_t>> Symbols);
+
+  /// Return the size of the symbol index member for \p NumSymbols symbols.
+  static uint64_t getSymbolIndexSize(uint32_t NumSymbols);
+
   bool isEmpty() const;
   bool hasSymbolTable() const;
   StringRef getSymbolTable() const { return SymbolTable; }
   StringRef getStringTable() const { return StringTable; }
+  /// Whether the archive has a symbol index member. findSymbol() ignores it
+  /// if it does not match the symbol table.
+  bool hasSymbolIndex() const { return !SymbolIndexMember.empty(); }
   uint32_t getNumberOfSymbols() const;
 
   std::vector<std::unique_ptr<MemoryBuffer>> takeThinBuffers() {
@@ -273,6 +302,14 @@ public:
 private:
   StringRef SymbolTable;
   StringRef StringTable;
+  StringRef SymbolIndexMember;
+
+  /// The index findSymbol() uses, either SymbolIndexMember or OwnedSymbolIndex.
+  mutable StringRef SymbolIndex;
+  mutable std::string OwnedSymbolIndex;
+  mutable llvm::once_flag SymbolIndexFlag;
+  bool readSymbolIndex(const Child &C);
+  void initSymbolIndex() const;
 
   StringRef FirstRegularData;
   uint16_t FirstRegularStartOfFile = -1;
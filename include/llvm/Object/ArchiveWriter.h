@@ -14,6 +14,7 @@
 #ifndef LLVM_OBJECT_ARCHIVEWRITER_H
 #define LLVM_OBJECT_ARCHIVEWRITER_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Support/Error.h"
@@ -27,6 +28,12 @@ struct NewArchiveMember {
   sys::TimePoint<std::chrono::seconds> ModTime;
   unsigned UID = 0, GID = 0, Perms = 0644;
 
+  /// The names of the symbols of the member that go in the symbol table, if
+  /// they are already known, for example from the symbol table of the archive
+  /// the member comes from. writeArchive() reads the symbols of the other
+  /// members from their contents.
+  Optional<std::vector<StringRef>> Symbols;
+
   bool IsNew = false;
   NewArchiveMember() = default;
   NewArchiveMember(MemoryBufferRef BufRef);
@@ -38,10 +45,18 @@ struct NewArchiveMember {
                                             bool Deterministic);
 };
 
+/// Write an archive with \p NewMembers to \p ArcName. The symbols of the
+/// members are read in parallel, and the archive is written straight into the
+/// output file, which replaces \p ArcName once it is complete.
+///
+/// If \p WriteSymbolIndex is set, the symbol table is followed by a symbol
+/// index member, which saves object::Archive::findSymbol() from building the
+/// index when the archive is read.
 Error writeArchive(StringRef ArcName, ArrayRef<NewArchiveMember> NewMembers,
                    bool WriteSymtab, object::Archive::Kind Kind,
                    bool Deterministic, bool Thin,
-                   std::unique_ptr<MemoryBuffer> OldArchiveBuf = nullptr);
+                   std::unique_ptr<MemoryBuffer> OldArchiveBuf = nullptr,
+                   bool WriteSymbolIndex = false);
 }
 
 #endif
@@ -13,6 +13,7 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Compression.h"
 
 namespace llvm {
 namespace object {
@@ -59,6 +60,7 @@ private:
 
   StringRef SectionData;
   uint64_t DecompressedSize;
+  compression::Format Format;
 };
 
 } // end namespace object
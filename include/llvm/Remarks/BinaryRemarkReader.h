@@ -0,0 +1,64 @@
+//===- llvm/Remarks/BinaryRemarkReader.h - Read binary remarks --*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares BinaryRemarkReader, which reads the optimization remarks
+// written by BinaryRemarkWriter.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BINARYREMARKREADER_H
+#define LLVM_REMARKS_BINARYREMARKREADER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace llvm {
+namespace remarks {
+
+/// Reads the remarks of a binary remark file one at a time. Files that were
+/// concatenated are read as one.
+class BinaryRemarkReader {
+public:
+  /// Return true if \p Buf starts like a binary remark file.
+  static bool isBinaryRemarks(StringRef Buf);
+
+  /// Create a reader of the remarks in \p Buf. The strings of the remarks
+  /// point into \p Buf, so it must outlive them.
+  static Expected<std::unique_ptr<BinaryRemarkReader>> create(StringRef Buf);
+
+  /// Read the next remark. Return null after the last one. The remark is
+  /// overwritten by the next call, but its strings stay valid.
+  Expected<const Remark *> next();
+
+private:
+  explicit BinaryRemarkReader(StringRef Buf) : Buf(Buf) {}
+
+  Error readHeader();
+  Error readNumber(uint64_t &N);
+  Error readString(StringRef &S);
+  Error readLocation(RemarkLocation &Loc);
+  Error makeError(const Twine &Msg) const;
+
+  StringRef Buf;
+  uint64_t Offset = 0;
+  /// The offset of the last field read, which errors refer to.
+  uint64_t FieldOffset = 0;
+  /// The strings defined so far in the current file.
+  std::vector<StringRef> Strings;
+  Remark Current;
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif // LLVM_REMARKS_BINARYREMARKREADER_H
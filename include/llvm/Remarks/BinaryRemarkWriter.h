@@ -0,0 +1,50 @@
+//===- llvm/Remarks/BinaryRemarkWriter.h - Write binary remarks -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares BinaryRemarkWriter, which streams optimization remarks to
+// a file in the binary remark format.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_BINARYREMARKWRITER_H
+#define LLVM_REMARKS_BINARYREMARKWRITER_H
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Remarks/Remark.h"
+
+namespace llvm {
+
+class raw_ostream;
+
+namespace remarks {
+
+/// Writes remarks in the binary remark format as they are emitted. The format
+/// is much smaller and faster to write and read than YAML: numbers are
+/// ULEB128-encoded, and every string is written once, by the first remark
+/// that uses it, which later remarks refer to by number.
+class BinaryRemarkWriter {
+public:
+  /// Start writing remarks to \p OS, beginning with the file header.
+  explicit BinaryRemarkWriter(raw_ostream &OS);
+
+  void emit(const Remark &R);
+
+private:
+  void emitString(StringRef S);
+  void emitLocation(const RemarkLocation &Loc);
+
+  raw_ostream &OS;
+  /// The numbers of the strings written so far.
+  StringMap<unsigned> StringIDs;
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif // LLVM_REMARKS_BINARYREMARKWRITER_H
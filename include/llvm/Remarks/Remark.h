@@ -0,0 +1,84 @@
+//===- llvm/Remarks/Remark.h - An optimization remark -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines Remark, the representation of an optimization remark that
+// the remark writers and readers share. Unlike the diagnostics in the IR
+// library, it only refers to strings, so it can describe remarks read back
+// from a file as well as the ones the compiler emits.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_REMARK_H
+#define LLVM_REMARKS_REMARK_H
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include <cstdint>
+#include <string>
+
+namespace llvm {
+namespace remarks {
+
+/// The kind of a remark.
+enum class Type : uint8_t {
+  Passed,
+  Missed,
+  Analysis,
+  AnalysisFPCommute,
+  AnalysisAliasing,
+  Failure,
+};
+
+/// Return the name of \p T, as in the tags of YAML remarks (without the "!").
+StringRef getTypeName(Type T);
+
+/// Parse a name returned by getTypeName.
+Optional<Type> parseTypeName(StringRef Name);
+
+/// A source location.
+struct RemarkLocation {
+  StringRef SourceFilePath;
+  unsigned SourceLine = 0;
+  unsigned SourceColumn = 0;
+};
+
+/// A key-value pair of a remark, optionally with the source location of the
+/// value.
+struct Argument {
+  StringRef Key;
+  StringRef Val;
+  Optional<RemarkLocation> Loc;
+};
+
+/// An optimization remark. The strings are owned by whoever created the
+/// remark: the diagnostic it was made from, or the buffer it was read from.
+struct Remark {
+  Type RemarkType = Type::Passed;
+  /// The name of the pass that emitted the remark.
+  StringRef PassName;
+  /// A textual identifier for the remark, unique within the pass.
+  StringRef RemarkName;
+  /// The name of the function the remark is about.
+  StringRef FunctionName;
+  Optional<RemarkLocation> Loc;
+  /// The number of times the code was executed, if profile data is
+  /// available.
+  Optional<uint64_t> Hotness;
+  SmallVector<Argument, 5> Args;
+
+  /// Return the message of the remark, which is the concatenation of its
+  /// values.
+  std::string getArgsAsMsg() const;
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif // LLVM_REMARKS_REMARK_H
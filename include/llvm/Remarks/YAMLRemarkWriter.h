@@ -0,0 +1,39 @@
+//===- llvm/Remarks/YAMLRemarkWriter.h - Write YAML remarks -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares YAMLRemarkWriter, which writes optimization remarks in
+// the YAML format of -pass-remarks-output.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_REMARKS_YAMLREMARKWRITER_H
+#define LLVM_REMARKS_YAMLREMARKWRITER_H
+
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Support/YAMLTraits.h"
+
+namespace llvm {
+namespace remarks {
+
+/// Writes remarks as YAML documents, in the same form as the compiler does,
+/// so that tools like opt-viewer can read them.
+class YAMLRemarkWriter {
+public:
+  explicit YAMLRemarkWriter(raw_ostream &OS) : YOut(OS) {}
+
+  void emit(const Remark &R);
+
+private:
+  yaml::Output YOut;
+};
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif // LLVM_REMARKS_YAMLREMARKWRITER_H
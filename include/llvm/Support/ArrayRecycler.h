@@ -113,7 +113,8 @@ public:
   ///
   /// There is no need to traverse the free lists, pulling all the objects into
   /// cache.
-  void clear(BumpPtrAllocator&) {
+  template <typename AllocatorT, size_t SlabSize, size_t SizeThreshold>
+  void clear(BumpPtrAllocatorImpl<AllocatorT, SlabSize, SizeThreshold> &) {
     Bucket.clear();
   }
 
@@ -0,0 +1,126 @@
+//===- CacheIndex.h - Indexed cache directory -------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines CacheIndex, which keeps track of the entries of a cache
+// directory in an append-only index file, so that lookups and pruning don't
+// have to walk and stat the directory.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_CACHEINDEX_H
+#define LLVM_SUPPORT_CACHEINDEX_H
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Error.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+
+class raw_fd_ostream;
+
+/// An index of the entries of a cache directory, such as the ThinLTO cache.
+///
+/// Entries are files named "llvmcache-<key>" in the directory, so the
+/// directory stays compatible with pruneCache(). The index lives next to them
+/// in "llvmcache.index", a log of one-line records that is only ever
+/// appended to: an entry being added, an entry being hit, an entry being
+/// removed. Opening the index replays the log into a hash table and a list of
+/// the entries in least recently used order. From then on, lookups are a hash
+/// table probe and pruning only looks at the entries it evicts.
+///
+/// Several processes may share a cache directory. Each record is written with
+/// a single append, and the log is compacted by atomically replacing it once
+/// it grows to several times the number of live entries. Records appended by
+/// other processes after this one opened the index are not seen by it, which
+/// at worst makes it evict an entry that was recently used elsewhere; entry
+/// files found on disk but missing from the index are adopted on lookup.
+///
+/// All member functions are thread safe.
+class CacheIndex {
+public:
+  struct Statistics {
+    /// Number of live entries and their total size in bytes.
+    uint64_t NumEntries = 0;
+    uint64_t TotalSize = 0;
+
+    /// Lookups that found an entry, entries added after a lookup that didn't,
+    /// and entries removed by pruning, over the lifetime of the cache.
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    uint64_t Evictions = 0;
+  };
+
+  /// Open the index of the cache directory \p Path, creating the directory
+  /// and the index if needed.
+  static Expected<std::unique_ptr<CacheIndex>> open(StringRef Path);
+
+  ~CacheIndex();
+
+  /// Return the path of the file holding the entry for \p Key.
+  std::string getEntryPath(StringRef Key) const;
+
+  /// Look up \p Key, recording a hit and refreshing its last access time if
+  /// it is present. Returns false if the entry doesn't exist.
+  bool lookup(StringRef Key);
+
+  /// Record that the file for \p Key was written, with size \p Size.
+  void insert(StringRef Key, uint64_t Size);
+
+  /// Remove the least recently used entries until the cache satisfies
+  /// \p Policy, deleting their files. The pruning interval of the policy is
+  /// ignored. Returns the number of entries removed.
+  uint64_t prune(const CachePruningPolicy &Policy);
+
+  Statistics getStatistics() const;
+
+  /// Rewrite the log with one record per live entry.
+  Error compact();
+
+private:
+  struct Entry {
+    uint64_t Size;
+    /// Last access time, in seconds since the epoch.
+    uint64_t LastAccess;
+    /// Position in the LRU list.
+    std::list<StringMapEntry<Entry> *>::iterator LRUPos;
+  };
+
+  explicit CacheIndex(StringRef Path);
+
+  Error replay();
+  Error openLog();
+  void appendRecord(StringRef Record);
+  void addEntry(StringRef Key, uint64_t Size, uint64_t Time);
+  void touchEntry(StringMapEntry<Entry> &E, uint64_t Time);
+  void removeEntry(StringMapEntry<Entry> &E);
+  void maybeCompact();
+
+  SmallString<128> Path;
+  SmallString<128> IndexPath;
+
+  mutable std::mutex Lock;
+  StringMap<Entry> Entries;
+  /// Entries from least to most recently used.
+  std::list<StringMapEntry<Entry> *> LRU;
+  Statistics Stats;
+  /// Number of records in the log, to decide when to compact it.
+  uint64_t NumRecords = 0;
+  std::unique_ptr<raw_fd_ostream> Log;
+};
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_CACHEINDEX_H
@@ -21,7 +21,7 @@ template <typename T> class SmallVectorImpl;
 class Error;
 class StringRef;
 
-namespace zlib {
+namespace compression {
 
 enum CompressionLevel {
   NoCompression,
@@ -30,6 +30,16 @@ enum CompressionLevel {
   BestSizeCompression
 };
 
+} // End of namespace compression
+
+namespace zlib {
+
+using compression::CompressionLevel;
+using compression::NoCompression;
+using compression::DefaultCompression;
+using compression::BestSpeedCompression;
+using compression::BestSizeCompression;
+
 bool isAvailable();
 
 Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
@@ -46,7 +56,81 @@ uint32_t crc32(StringRef Buffer);
 
 }  // End of namespace zlib
 
+namespace zstd {
+
+bool isAvailable();
+
+Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
+               compression::CompressionLevel Level =
+                   compression::DefaultCompression);
+
+/// Uncompress \p InputBuffer, which may hold several frames, such as the
+/// output of compression::compressParallel. Frames are uncompressed on
+/// several threads when their sizes are recorded in their headers.
+Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+}  // End of namespace zstd
+
+/// LZ4 block format. The compressed data doesn't record its own size, so
+/// \p InputBuffer must be exactly the output of compress.
+namespace lz4 {
+
+bool isAvailable();
+
+Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
+               compression::CompressionLevel Level =
+                   compression::DefaultCompression);
+
+Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+}  // End of namespace lz4
+
+/// Entry points that take the codec as a parameter, for clients that let the
+/// user pick one.
+namespace compression {
+
+enum class Format { Zlib, Zstd, LZ4 };
+
+/// Return the name of \p F, as used on command lines ("zlib", "zstd", "lz4").
+StringRef getName(Format F);
+
+/// Return true if LLVM was built with support for \p F.
+bool isAvailable(Format F);
+
+Error compress(Format F, StringRef InputBuffer,
+               SmallVectorImpl<char> &CompressedBuffer,
+               CompressionLevel Level = DefaultCompression);
+
+Error uncompress(Format F, StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(Format F, StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+/// Compress \p InputBuffer in chunks of \p ChunkSize bytes on several
+/// threads. The result is a single stream that uncompress accepts: for zlib,
+/// one deflate stream made of independently compressed, flushed pieces; for
+/// zstd, one frame per chunk. The output only depends on \p ChunkSize, not
+/// on the number of threads. Inputs that fit in one chunk, and lz4, whose
+/// blocks can't be concatenated, are compressed as by compress.
+Error compressParallel(Format F, StringRef InputBuffer,
+                       SmallVectorImpl<char> &CompressedBuffer,
+                       CompressionLevel Level = DefaultCompression,
+                       size_t ChunkSize = 1 << 20);
+
+} // End of namespace compression
+
 } // End of namespace llvm
 
 #endif
-
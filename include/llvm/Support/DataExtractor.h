@@ -395,6 +395,38 @@ public:
   ///     The extracted unsigned integer value.
   uint64_t getULEB128(uint32_t *offset_ptr) const;
 
+  /// Extract \a count signed LEB128 values from \a *offset_ptr.
+  ///
+  /// This is equivalent to calling getSLEB128() \a count times, but
+  /// decodes runs of short values several at a time.
+  ///
+  /// @param[in,out] offset_ptr
+  ///     A pointer to an offset within the data that will be advanced
+  ///     past the extracted values.
+  ///
+  /// @param[out] dst
+  ///     A buffer to copy \a count signed integers into.
+  ///
+  /// @param[in] count
+  ///     The number of values to extract.
+  void getSLEB128(uint32_t *offset_ptr, int64_t *dst, uint32_t count) const;
+
+  /// Extract \a count unsigned LEB128 values from \a *offset_ptr.
+  ///
+  /// This is equivalent to calling getULEB128() \a count times, but
+  /// decodes runs of short values several at a time.
+  ///
+  /// @param[in,out] offset_ptr
+  ///     A pointer to an offset within the data that will be advanced
+  ///     past the extracted values.
+  ///
+  /// @param[out] dst
+  ///     A buffer to copy \a count unsigned integers into.
+  ///
+  /// @param[in] count
+  ///     The number of values to extract.
+  void getULEB128(uint32_t *offset_ptr, uint64_t *dst, uint32_t count) const;
+
   /// Test the validity of \a offset.
   ///
   /// @return
@@ -178,14 +178,34 @@ inline int64_t decodeSLEB128(const uint8_t *p, unsigned *n = nullptr,
     Value |= (int64_t(Byte & 0x7f) << Shift);
     Shift += 7;
   } while (Byte >= 128);
-  // Sign extend negative numbers.
-  if (Byte & 0x40)
+  // Sign extend negative numbers, unless the value already fills 64 bits.
+  if (Shift < 64 && (Byte & 0x40))
     Value |= (-1ULL) << Shift;
   if (n)
     *n = (unsigned)(p - orig_p);
   return Value;
 }
 
+/// Utility function to decode up to \p Count consecutive ULEB128 values from
+/// the bytes in [\p p, \p end) into \p Out. Returns the number of values
+/// decoded, which is less than \p Count only if a value is malformed, in
+/// which case \p error is set as by decodeULEB128. \p n is set to the number
+/// of bytes taken by the decoded values.
+///
+/// Runs of one-byte values are decoded several at a time, with SSE4.1 or
+/// AVX2 if the host supports them.
+extern size_t decodeULEB128Array(const uint8_t *p, const uint8_t *end,
+                                 uint64_t *Out, size_t Count,
+                                 size_t *n = nullptr,
+                                 const char **error = nullptr);
+
+/// Utility function to decode up to \p Count consecutive SLEB128 values, like
+/// decodeULEB128Array.
+extern size_t decodeSLEB128Array(const uint8_t *p, const uint8_t *end,
+                                 int64_t *Out, size_t Count,
+                                 size_t *n = nullptr,
+                                 const char **error = nullptr);
+
 /// Utility function to get the size of the ULEB128-encoded value.
 extern unsigned getULEB128Size(uint64_t Value);
 
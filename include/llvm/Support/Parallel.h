@@ -60,10 +60,18 @@ public:
     ++Count;
   }
 
-  void dec() {
+  /// Returns true if this brought the count down to zero.
+  bool dec() {
     std::lock_guard<std::mutex> lock(Mutex);
-    if (--Count == 0)
-      Cond.notify_all();
+    if (--Count != 0)
+      return false;
+    Cond.notify_all();
+    return true;
+  }
+
+  bool isDone() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
   }
 
   void sync() const {
@@ -72,13 +80,18 @@ public:
   }
 };
 
+/// A set of tasks that can be waited on together. Tasks may themselves spawn
+/// into and sync on task groups: a worker thread waiting in sync() runs other
+/// pending tasks in the meantime instead of blocking.
 class TaskGroup {
   Latch L;
 
 public:
+  ~TaskGroup() { sync(); }
+
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  void sync() const;
 };
 
 #if defined(_MSC_VER)
@@ -78,7 +78,10 @@ public:
   ///
   /// There is no need to traverse the free list, pulling all the objects into
   /// cache.
-  void clear(BumpPtrAllocator &) { FreeList = nullptr; }
+  template <typename AllocatorT, size_t SlabSize, size_t SizeThreshold>
+  void clear(BumpPtrAllocatorImpl<AllocatorT, SlabSize, SizeThreshold> &) {
+    FreeList = nullptr;
+  }
 
   template<class SubClass, class AllocatorType>
   SubClass *Allocate(AllocatorType &Allocator) {
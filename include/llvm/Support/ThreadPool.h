@@ -7,7 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file defines a crude C++11 based thread pool.
+// This file defines a C++11 based thread pool.
 //
 //===----------------------------------------------------------------------===//
 
@@ -15,6 +15,7 @@
 #define LLVM_SUPPORT_THREAD_POOL_H
 
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Support/WorkStealingExecutor.h"
 #include "llvm/Support/thread.h"
 
 #include <future>
@@ -32,8 +33,10 @@ namespace llvm {
 /// A ThreadPool for asynchronous parallel execution on a defined number of
 /// threads.
 ///
-/// The pool keeps a vector of threads alive, waiting on a condition variable
-/// for some work to become available.
+/// The pool keeps a vector of threads alive, each owning a deque of tasks and
+/// stealing from the others when it runs out of work. A task submitted from
+/// one of the pool's threads goes to that thread's own deque, so tasks may
+/// submit further tasks to the pool.
 class ThreadPool {
 public:
   using TaskTy = std::function<void()>;
@@ -66,7 +69,8 @@ public:
   }
 
   /// Blocking wait for all the threads to complete and the queue to be empty.
-  /// It is an error to try to add new tasks while blocking on this call.
+  /// Tasks spawned by running tasks are waited for as well. It is an error to
+  /// call this from one of the pool's tasks.
   void wait();
 
 private:
@@ -74,26 +78,12 @@ private:
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   std::shared_future<void> asyncImpl(TaskTy F);
 
-  /// Threads in flight
-  std::vector<llvm::thread> Threads;
-
+#if LLVM_ENABLE_THREADS
+  /// The executor owning the threads and the per-thread task deques.
+  std::unique_ptr<WorkStealingExecutor> Executor;
+#else
   /// Tasks waiting for execution in the pool.
   std::queue<PackagedTaskTy> Tasks;
-
-  /// Locking and signaling for accessing the Tasks queue.
-  std::mutex QueueLock;
-  std::condition_variable QueueCondition;
-
-  /// Locking and signaling for job completion
-  std::mutex CompletionLock;
-  std::condition_variable CompletionCondition;
-
-  /// Keep track of the number of thread actually busy
-  std::atomic<unsigned> ActiveThreads;
-
-#if LLVM_ENABLE_THREADS // avoids warning for unused variable
-  /// Signal for the destruction of the pool, asking thread to exit.
-  bool EnableFlag;
 #endif
 };
 }
@@ -0,0 +1,139 @@
+//===- llvm/Support/WorkStealingExecutor.h - Work stealing ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines a work-stealing executor shared by the parallel algorithms
+// in Parallel.h and by ThreadPool.
+//
+// Every worker thread owns a deque of tasks. A task added from a worker thread
+// is pushed onto the back of that worker's deque and the owner pops from the
+// back, so nested spawns stay local and run in LIFO order. Tasks added from
+// other threads are distributed round-robin over the deques. An idle worker
+// steals from the front of the other workers' deques. There is no lock shared
+// by all producers and consumers: each deque has its own lock, and the shared
+// lock is only taken to put idle threads to sleep and to wake them up.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_WORKSTEALINGEXECUTOR_H
+#define LLVM_SUPPORT_WORKSTEALINGEXECUTOR_H
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/llvm-config.h"
+
+#if LLVM_ENABLE_THREADS
+
+#include "llvm/Support/thread.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+/// A pool of worker threads with one task deque per worker.
+///
+/// A task may add further tasks to the executor it runs on and then wait for
+/// them with helpUntil(); the waiting worker keeps running pending tasks
+/// instead of blocking, so nested fork/join parallelism cannot deadlock the
+/// pool even when every worker is waiting on its children.
+class WorkStealingExecutor {
+public:
+  using TaskTy = std::function<void()>;
+
+  /// Construct an executor running tasks on \p ThreadCount worker threads.
+  explicit WorkStealingExecutor(unsigned ThreadCount);
+
+  /// Blocking destructor: every task already added is run before the worker
+  /// threads are joined.
+  ~WorkStealingExecutor();
+
+  WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+  WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+  /// Queue \p Task for asynchronous execution. When called from one of this
+  /// executor's workers the task goes to that worker's own deque.
+  void add(TaskTy Task);
+
+  /// Run one pending task on the calling thread. Returns false if no task
+  /// could be found.
+  bool runOne();
+
+  /// Run pending tasks on the calling thread until \p Done returns true.
+  /// Whoever makes \p Done true must call notifyWaiters() afterwards so that a
+  /// thread sleeping here re-evaluates it.
+  void helpUntil(function_ref<bool()> Done);
+
+  /// Wake up the threads sleeping in helpUntil().
+  void notifyWaiters();
+
+  /// Blocking wait until every task added so far, and every task those tasks
+  /// added, has finished. Must not be called from one of the worker threads.
+  void wait();
+
+  /// Return true if the calling thread is one of this executor's workers.
+  bool isWorkerThread() const;
+
+  unsigned getThreadCount() const { return Threads.size(); }
+
+private:
+  struct WorkQueue {
+    std::mutex Lock;
+    std::deque<TaskTy> Tasks;
+  };
+
+  /// Main loop of the worker owning the deque at \p Index.
+  void work(unsigned Index);
+
+  /// Pop a task from the back of the deque at \p Index, or steal one from the
+  /// front of another deque. \p Index may be out of range for threads that are
+  /// not workers, which then only steal.
+  bool getTask(unsigned Index, TaskTy &Task);
+
+  void runTask(TaskTy &Task);
+
+  /// Block until \p Done returns true or a task is available.
+  void sleepUntil(function_ref<bool()> Done);
+
+  std::vector<std::unique_ptr<WorkQueue>> Queues;
+  std::vector<llvm::thread> Threads;
+
+  /// Deque receiving the next task added from outside the pool.
+  std::atomic<unsigned> NextQueue{0};
+
+  /// Number of tasks sitting in a deque.
+  std::atomic<size_t> Queued{0};
+
+  /// Number of tasks that are either queued or running.
+  std::atomic<size_t> Outstanding{0};
+
+  /// Number of threads sleeping (or about to) on SleepCondition.
+  std::atomic<unsigned> Sleepers{0};
+
+  /// Locking and signaling for idle threads.
+  std::mutex SleepLock;
+  std::condition_variable SleepCondition;
+
+  /// Locking and signaling for wait().
+  std::mutex CompletionLock;
+  std::condition_variable CompletionCondition;
+
+  /// Signal for the destruction of the executor, asking workers to exit once
+  /// the deques are empty. Guarded by SleepLock.
+  bool Stop = false;
+};
+
+} // namespace llvm
+
+#endif // LLVM_ENABLE_THREADS
+
+#endif // LLVM_SUPPORT_WORKSTEALINGEXECUTOR_H
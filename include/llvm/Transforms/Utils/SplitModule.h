@@ -26,6 +26,12 @@ class Module;
 /// Splits the module M into N linkable partitions. The function ModuleCallback
 /// is called N times passing each individual partition as the MPart argument.
 ///
+/// If PreserveLocals is true, locals are kept in the partition of their users
+/// instead of being externalized. If PreserveOrder is true, each partition is
+/// a contiguous run of M's definitions and the partitions are passed to
+/// ModuleCallback in module order, so that linking them in that order keeps
+/// the original layout.
+///
 /// FIXME: This function does not deal with the somewhat subtle symbol
 /// visibility issues around module splitting, including (but not limited to):
 ///
@@ -36,7 +42,7 @@ class Module;
 void SplitModule(
     std::unique_ptr<Module> M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals = false);
+    bool PreserveLocals = false, bool PreserveOrder = false);
 
 } // end namespace llvm
 
@@ -3338,6 +3338,9 @@ Error BitcodeReader::parseBitcodeInto(Module *M, bool ShouldLazyLoadMetadata,
   TheModule = M;
   MDLoader = MetadataLoader(Stream, *M, ValueList, IsImporting,
                             [&](unsigned ID) { return getTypeByID(ID); });
+  // A client deferring metadata only wants the metadata reachable from what
+  // it materializes, so index the module metadata rather than decoding it.
+  MDLoader->setLazyLoadModuleMetadata(ShouldLazyLoadMetadata);
   return parseModule(0, ShouldLazyLoadMetadata);
 }
 
@@ -5826,6 +5829,46 @@ Expected<BitcodeLTOInfo> BitcodeModule::getLTOInfo() {
   }
 }
 
+Expected<ModuleHash> BitcodeModule::getModuleHash() {
+  BitstreamCursor Stream(Buffer);
+  Stream.JumpToBit(ModuleBit);
+
+  if (Stream.EnterSubBlock(bitc::MODULE_BLOCK_ID))
+    return error("Invalid record");
+
+  ModuleHash Hash = {{0}};
+  SmallVector<uint64_t, 5> Record;
+  while (true) {
+    BitstreamEntry Entry = Stream.advance();
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+      return error("Malformed block");
+    case BitstreamEntry::EndBlock:
+      return Hash;
+
+    case BitstreamEntry::SubBlock:
+      if (Stream.SkipBlock())
+        return error("Malformed block");
+      continue;
+
+    case BitstreamEntry::Record: {
+      // Only decode the one record we're interested in.
+      uint64_t RecordBit = Stream.GetCurrentBitNo();
+      if (Stream.skipRecord(Entry.ID) != bitc::MODULE_CODE_HASH)
+        continue;
+      Stream.JumpToBit(RecordBit);
+      Stream.readRecord(Entry.ID, Record);
+      if (Record.size() != 5)
+        return error("Invalid hash length " + Twine(Record.size()).str());
+      for (unsigned I = 0; I != 5; ++I)
+        Hash[I] = Record[I];
+      return Hash;
+    }
+    }
+  }
+}
+
 static Expected<BitcodeModule> getSingleModule(MemoryBufferRef Buffer) {
   Expected<std::vector<BitcodeModule>> MsOrErr = getBitcodeModuleList(Buffer);
   if (!MsOrErr)
@@ -182,8 +182,7 @@ unsigned BitstreamCursor::readRecord(unsigned AbbrevID,
   if (AbbrevID == bitc::UNABBREV_RECORD) {
     unsigned Code = ReadVBR(6);
     unsigned NumElts = ReadVBR(6);
-    for (unsigned i = 0; i != NumElts; ++i)
-      Vals.push_back(ReadVBR64(6));
+    readVBR64Array(6, NumElts, Vals);
     return Code;
   }
 
@@ -236,8 +235,7 @@ unsigned BitstreamCursor::readRecord(unsigned AbbrevID,
           Vals.push_back(Read((unsigned)EltEnc.getEncodingData()));
         break;
       case BitCodeAbbrevOp::VBR:
-        for (; NumElts; --NumElts)
-          Vals.push_back(ReadVBR64((unsigned)EltEnc.getEncodingData()));
+        readVBR64Array((unsigned)EltEnc.getEncodingData(), NumElts, Vals);
         break;
       case BitCodeAbbrevOp::Char6:
         for (; NumElts; --NumElts)
@@ -100,7 +100,7 @@ static cl::opt<bool> ImportFullTypeDefinitions(
 static cl::opt<bool> DisableLazyLoading(
     "disable-ondemand-mds-loading", cl::init(false), cl::Hidden,
     cl::desc("Force disable the lazy-loading on-demand of metadata when "
-             "loading bitcode for importing."));
+             "loading bitcode for importing or with lazy metadata."));
 
 namespace {
 
@@ -459,6 +459,10 @@ class MetadataLoader::MetadataLoaderImpl {
   /// True if metadata is being parsed for a module being ThinLTO imported.
   bool IsImporting = false;
 
+  /// True if the module-level metadata block should be indexed and loaded on
+  /// demand even though we aren't importing.
+  bool LazyLoadModuleMetadata = false;
+
   Error parseOneMetadata(SmallVectorImpl<uint64_t> &Record, unsigned Code,
                          PlaceholderQueue &Placeholders, StringRef Blob,
                          unsigned &NextMetadataNo);
@@ -668,6 +672,8 @@ public:
   void setStripTBAA(bool Value) { StripTBAA = Value; }
   bool isStrippingTBAA() { return StripTBAA; }
 
+  void setLazyLoadModuleMetadata(bool Value) { LazyLoadModuleMetadata = Value; }
+
   unsigned size() const { return MetadataList.size(); }
   void shrinkTo(unsigned N) { MetadataList.shrinkTo(N); }
   void upgradeDebugIntrinsics(Function &F) { upgradeDeclareExpressions(F); }
@@ -857,8 +863,8 @@ Error MetadataLoader::MetadataLoaderImpl::parseMetadata(bool ModuleLevel) {
 
   // We lazy-load module-level metadata: we build an index for each record, and
   // then load individual record as needed, starting with the named metadata.
-  if (ModuleLevel && IsImporting && MetadataList.empty() &&
-      !DisableLazyLoading) {
+  if (ModuleLevel && (IsImporting || LazyLoadModuleMetadata) &&
+      MetadataList.empty() && !DisableLazyLoading) {
     auto SuccessOrErr = lazyLoadModuleMetadataBlock();
     if (!SuccessOrErr)
       return SuccessOrErr.takeError();
@@ -2007,6 +2013,10 @@ void MetadataLoader::setStripTBAA(bool StripTBAA) {
 
 bool MetadataLoader::isStrippingTBAA() { return Pimpl->isStrippingTBAA(); }
 
+void MetadataLoader::setLazyLoadModuleMetadata(bool LazyLoad) {
+  Pimpl->setLazyLoadModuleMetadata(LazyLoad);
+}
+
 unsigned MetadataLoader::size() const { return Pimpl->size(); }
 void MetadataLoader::shrinkTo(unsigned N) { return Pimpl->shrinkTo(N); }
 
@@ -58,6 +58,11 @@ public:
   /// Return true if the Loader is stripping TBAA metadata.
   bool isStrippingTBAA();
 
+  /// Index the module-level metadata block instead of parsing it, and load
+  /// records on demand, as is done when importing. This is only effective for
+  /// blocks written with a metadata index.
+  void setLazyLoadModuleMetadata(bool LazyLoad = true);
+
   // Return true there are remaining unresolved forward references.
   bool hasFwdRefs() const;
 
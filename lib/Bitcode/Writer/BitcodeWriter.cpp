@@ -68,8 +68,10 @@
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -87,6 +89,10 @@ static cl::opt<unsigned>
                    cl::desc("Number of metadatas above which we emit an index "
                             "to enable lazy-loading"));
 
+static cl::opt<unsigned> WriteThreads(
+    "bitcode-write-threads", cl::Hidden, cl::init(1),
+    cl::desc("Number of threads used to encode function blocks"));
+
 cl::opt<bool> WriteRelBFToSummary(
     "write-relbf-to-summary", cl::Hidden, cl::init(false),
     cl::desc("Write relative block frequency to function summary "));
@@ -202,6 +208,14 @@ public:
   }
 
 protected:
+  /// Constructs a ModuleBitcodeWriterBase object that writes the function
+  /// blocks of \p Parent's module to \p Stream, with its own copy of the
+  /// module-level value enumeration.
+  ModuleBitcodeWriterBase(const ModuleBitcodeWriterBase &Parent,
+                          BitstreamWriter &Stream)
+      : BitcodeWriterBase(Stream, Parent.StrtabBuilder), M(Parent.M),
+        VE(Parent.VE), Index(nullptr), GlobalValueId(Parent.GlobalValueId) {}
+
   void writePerModuleGlobalValueSummary();
 
 private:
@@ -272,6 +286,13 @@ public:
   void write();
 
 private:
+  /// Constructs a ModuleBitcodeWriter object that encodes function blocks
+  /// of \p Parent's module into \p Buffer through \p Stream.
+  ModuleBitcodeWriter(const ModuleBitcodeWriter &Parent,
+                      SmallVectorImpl<char> &Buffer, BitstreamWriter &Stream)
+      : ModuleBitcodeWriterBase(Parent, Stream), Buffer(Buffer),
+        GenerateHash(false), ModHash(nullptr), BitcodeStartBit(0) {}
+
   uint64_t bitcodeStartBit() { return BitcodeStartBit; }
 
   size_t addToStrtab(StringRef Str);
@@ -384,6 +405,9 @@ private:
   void
   writeFunction(const Function &F,
                 DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
+  void writeFunctionBlockContents(const Function &F);
+  void writeFunctionBlocks(
+      DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
   void writeBlockInfo();
   void writeModuleHash(size_t BlockStartPos);
 
@@ -3037,6 +3061,12 @@ void ModuleBitcodeWriter::writeFunction(
   FunctionToBitcodeIndex[&F] = Stream.GetCurrentBitNo();
 
   Stream.EnterSubblock(bitc::FUNCTION_BLOCK_ID, 4);
+  writeFunctionBlockContents(F);
+  Stream.ExitBlock();
+}
+
+/// Emit the records and sub-blocks of a function block.
+void ModuleBitcodeWriter::writeFunctionBlockContents(const Function &F) {
   VE.incorporateFunction(F);
 
   SmallVector<unsigned, 64> Vals;
@@ -3103,7 +3133,57 @@ void ModuleBitcodeWriter::writeFunction(
   if (VE.shouldPreserveUseListOrder())
     writeUseListBlock(&F);
   VE.purgeFunction();
-  Stream.ExitBlock();
+}
+
+/// Emit the bodies of all the defined functions, in module order.
+void ModuleBitcodeWriter::writeFunctionBlocks(
+    DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex) {
+  std::vector<const Function *> Functions;
+  for (const Function &F : M)
+    if (!F.isDeclaration())
+      Functions.push_back(&F);
+
+  // Use-list orders are queued in the order the functions are written, so
+  // they force a serial write.
+  unsigned NumThreads = std::min<size_t>(WriteThreads, Functions.size());
+  if (NumThreads <= 1 || VE.shouldPreserveUseListOrder()) {
+    for (const Function *F : Functions)
+      writeFunction(*F, FunctionToBitcodeIndex);
+    return;
+  }
+
+  // A function block only depends on the module-level value enumeration and
+  // abbreviations, so each worker encodes whole blocks with its own copy of
+  // the enumerator, and we splice the contents of the blocks into the module
+  // block in order. Only the block headers depend on the final position.
+  std::vector<SmallVector<char, 0>> Contents(Functions.size());
+  std::atomic<size_t> NextFunction(0);
+  {
+    ThreadPool Pool(NumThreads);
+    for (unsigned I = 0; I != NumThreads; ++I)
+      Pool.async([&] {
+        SmallVector<char, 0> WorkerBuffer;
+        BitstreamWriter WorkerStream(WorkerBuffer);
+        WorkerStream.InheritBlockInfo(Stream);
+        ModuleBitcodeWriter Writer(*this, WorkerBuffer, WorkerStream);
+        for (size_t FI = NextFunction++; FI < Functions.size();
+             FI = NextFunction++) {
+          WorkerStream.EnterSubblock(bitc::FUNCTION_BLOCK_ID, 4);
+          size_t ContentsStart = WorkerStream.GetCurrentBitNo() / 8;
+          Writer.writeFunctionBlockContents(*Functions[FI]);
+          WorkerStream.ExitBlock();
+          Contents[FI].assign(WorkerBuffer.begin() + ContentsStart,
+                              WorkerBuffer.end());
+          WorkerBuffer.clear();
+        }
+      });
+  }
+
+  for (size_t FI = 0, FE = Functions.size(); FI != FE; ++FI) {
+    // Record the start of the block for the VST, as writeFunction does.
+    FunctionToBitcodeIndex[Functions[FI]] = Stream.GetCurrentBitNo();
+    Stream.EmitEncodedBlock(bitc::FUNCTION_BLOCK_ID, 4, Contents[FI]);
+  }
 }
 
 // Emit blockinfo, which defines the standard abbreviations etc.
@@ -3960,9 +4040,7 @@ void ModuleBitcodeWriter::write() {
 
   // Emit function bodies.
   DenseMap<const Function *, uint64_t> FunctionToBitcodeIndex;
-  for (Module::const_iterator F = M.begin(), E = M.end(); F != E; ++F)
-    if (!F->isDeclaration())
-      writeFunction(*F, FunctionToBitcodeIndex);
+  writeFunctionBlocks(FunctionToBitcodeIndex);
 
   // Need to write after the above call to WriteFunction which populates
   // the summary information in the index.
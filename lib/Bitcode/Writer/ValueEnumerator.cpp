@@ -441,6 +441,26 @@ ValueEnumerator::ValueEnumerator(const Module &M,
   organizeMetadata();
 }
 
+ValueEnumerator::ValueEnumerator(const ValueEnumerator &VE)
+    : TypeMap(VE.TypeMap), Types(VE.Types), ValueMap(VE.ValueMap),
+      Values(VE.Values), Comdats(VE.Comdats), MDs(VE.MDs),
+      FunctionMDs(VE.FunctionMDs), MetadataMap(VE.MetadataMap),
+      FunctionMDInfo(VE.FunctionMDInfo),
+      ShouldPreserveUseListOrder(VE.ShouldPreserveUseListOrder),
+      AttributeGroupMap(VE.AttributeGroupMap),
+      AttributeGroups(VE.AttributeGroups),
+      AttributeListMap(VE.AttributeListMap), AttributeLists(VE.AttributeLists),
+      GlobalBasicBlockIDs(VE.GlobalBasicBlockIDs),
+      InstructionMap(VE.InstructionMap), InstructionCount(VE.InstructionCount),
+      BasicBlocks(VE.BasicBlocks), NumModuleValues(VE.NumModuleValues),
+      NumModuleMDs(VE.NumModuleMDs), NumMDStrings(VE.NumMDStrings),
+      FirstFuncConstantID(VE.FirstFuncConstantID),
+      FirstInstID(VE.FirstInstID) {
+  assert(!ShouldPreserveUseListOrder &&
+         "Use-list orders are consumed in function order");
+  assert(BasicBlocks.empty() && "Copying with a function incorporated");
+}
+
 unsigned ValueEnumerator::getInstructionID(const Instruction *Inst) const {
   InstructionMapType::const_iterator I = InstructionMap.find(Inst);
   assert(I != InstructionMap.end() && "Instruction is not mapped!");
@@ -141,7 +141,10 @@ private:
 
 public:
   ValueEnumerator(const Module &M, bool ShouldPreserveUseListOrder);
-  ValueEnumerator(const ValueEnumerator &) = delete;
+  /// Copy the module-level enumeration of \p VE, to give each thread encoding
+  /// function blocks its own enumerator. \p VE must not have a function
+  /// incorporated, nor preserve use-list order.
+  explicit ValueEnumerator(const ValueEnumerator &VE);
   ValueEnumerator &operator=(const ValueEnumerator &) = delete;
 
   void dump() const;
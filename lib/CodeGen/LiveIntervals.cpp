@@ -18,8 +18,10 @@
 #include "LiveRangeCalc.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Twine.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/CodeGen/LiveInterval.h"
@@ -83,6 +85,11 @@ cl::opt<bool> UseSegmentSetForPhysRegs(
     cl::desc(
         "Use segment set for the computation of the live ranges of physregs."));
 
+cl::opt<bool> VerifyLivenessUpdates(
+    "verify-liveness-updates", cl::Hidden,
+    cl::desc("Check incremental updates of live intervals against a "
+             "computation from scratch."));
+
 } // end namespace llvm
 
 void LiveIntervals::getAnalysisUsage(AnalysisUsage &AU) const {
@@ -306,6 +313,22 @@ void LiveIntervals::computeRegUnitRange(LiveRange &LR, unsigned Unit) {
     LR.flushSegmentSet();
 }
 
+void LiveIntervals::computeRegUnitRangeWithLiveIns(LiveRange &LR,
+                                                   unsigned Unit) {
+  assert(LR.empty() && "Should only compute empty ranges.");
+  for (const MachineBasicBlock &MBB : *MF) {
+    if ((&MBB != &MF->front() && !MBB.isEHPad()) || MBB.livein_empty())
+      continue;
+    SlotIndex Begin = Indexes->getMBBStartIdx(&MBB);
+    for (const auto &LI : MBB.liveins()) {
+      for (MCRegUnitIterator Units(LI.PhysReg, TRI); Units.isValid(); ++Units)
+        if (*Units == Unit)
+          LR.createDeadDef(Begin, getVNInfoAllocator());
+    }
+  }
+  computeRegUnitRange(LR, Unit);
+}
+
 /// Precompute the live ranges of any register units that are live-in to an ABI
 /// block somewhere. Register values can appear without a corresponding def when
 /// entering the entry block or a landing pad.
@@ -1414,17 +1437,241 @@ private:
   }
 };
 
+/// Collect the registers read or written by \p MI, without duplicates.
+static void collectOperandRegs(const MachineInstr &MI,
+                               SmallVectorImpl<unsigned> &Regs) {
+  for (const MachineOperand &MO : MI.operands())
+    if (MO.isReg() && MO.getReg() && !is_contained(Regs, MO.getReg()))
+      Regs.push_back(MO.getReg());
+}
+
 void LiveIntervals::handleMove(MachineInstr &MI, bool UpdateFlags) {
   assert(!MI.isBundled() && "Can't handle bundled instructions yet.");
   SlotIndex OldIndex = Indexes->getInstructionIndex(MI);
+  if (Indexes->getMBBFromIndex(OldIndex) != MI.getParent()) {
+    handleMoveAcrossBlocks(MI);
+    return;
+  }
   Indexes->removeMachineInstrFromMaps(MI);
   SlotIndex NewIndex = Indexes->insertMachineInstrInMaps(MI);
-  assert(getMBBStartIdx(MI.getParent()) <= OldIndex &&
-         OldIndex < getMBBEndIdx(MI.getParent()) &&
-         "Cannot handle moves across basic block boundaries.");
 
   HMEditor HME(*this, *MRI, *TRI, OldIndex, NewIndex, UpdateFlags);
   HME.updateAllRanges(&MI);
+
+  if (VerifyLivenessUpdates) {
+    SmallVector<unsigned, 8> Regs;
+    collectOperandRegs(MI, Regs);
+    verifyRegs(Regs, "After handleMove");
+  }
+}
+
+void LiveIntervals::handleMoveAcrossBlocks(MachineInstr &MI) {
+  LLVM_DEBUG(dbgs() << "handleMove to " << printMBBReference(*MI.getParent())
+                    << ": " << MI);
+  removeRegMaskSlots(MI);
+  Indexes->removeMachineInstrFromMaps(MI);
+  Indexes->insertMachineInstrInMaps(MI);
+  insertRegMaskSlots(MI);
+
+  // The kills of the registers MI reads may have moved anywhere.
+  SmallVector<unsigned, 8> Regs;
+  collectOperandRegs(MI, Regs);
+  for (MachineOperand &MO : MI.operands())
+    if (MO.isReg() && MO.isUse())
+      MO.setIsKill(false);
+  for (unsigned Reg : Regs)
+    if (TargetRegisterInfo::isVirtualRegister(Reg))
+      MRI->clearKillFlags(Reg);
+
+  recomputeIntervals(Regs);
+  if (VerifyLivenessUpdates)
+    verifyRegs(Regs, "After handleMove");
+}
+
+SlotIndex LiveIntervals::handleInsert(MachineInstr &MI) {
+  assert(!MI.isBundled() && "Can't handle bundled instructions yet.");
+  SlotIndex Index = Indexes->insertMachineInstrInMaps(MI);
+  insertRegMaskSlots(MI);
+
+  // A register read by MI may have been killed before it.
+  SmallVector<unsigned, 8> Regs;
+  collectOperandRegs(MI, Regs);
+  for (unsigned Reg : Regs)
+    if (TargetRegisterInfo::isVirtualRegister(Reg))
+      MRI->clearKillFlags(Reg);
+
+  recomputeIntervals(Regs);
+  if (VerifyLivenessUpdates)
+    verifyRegs(Regs, "After handleInsert");
+  return Index;
+}
+
+void LiveIntervals::eraseInstr(MachineInstr &MI) {
+  assert(!MI.isBundled() && "Can't handle bundled instructions yet.");
+  SmallVector<unsigned, 8> Regs;
+  collectOperandRegs(MI, Regs);
+  removeRegMaskSlots(MI);
+  Indexes->removeMachineInstrFromMaps(MI);
+  MI.eraseFromParent();
+
+  recomputeIntervals(Regs);
+  if (VerifyLivenessUpdates)
+    verifyRegs(Regs, "After eraseInstr");
+}
+
+void LiveIntervals::recomputeIntervals(ArrayRef<unsigned> Regs) {
+  for (unsigned Reg : Regs) {
+    if (TargetRegisterInfo::isVirtualRegister(Reg)) {
+      if (!hasInterval(Reg)) {
+        if (!MRI->reg_nodbg_empty(Reg))
+          createAndComputeVirtRegInterval(Reg);
+        continue;
+      }
+      // computeVirtRegInterval() adds the dead flags that are still right.
+      for (MachineOperand &MO : MRI->def_operands(Reg))
+        MO.setIsDead(false);
+      LiveInterval &LI = getInterval(Reg);
+      LI.clear();
+      LI.clearSubRanges();
+      if (!MRI->reg_nodbg_empty(Reg))
+        computeVirtRegInterval(LI);
+      continue;
+    }
+
+    // Units whose ranges have not been computed yet will be on demand.
+    for (MCRegUnitIterator Units(Reg, TRI); Units.isValid(); ++Units) {
+      LiveRange *LR = getCachedRegUnit(*Units);
+      if (!LR)
+        continue;
+      LiveRange NewLR(UseSegmentSetForPhysRegs);
+      computeRegUnitRangeWithLiveIns(NewLR, *Units);
+      LR->clear();
+      LR->assign(NewLR, getVNInfoAllocator());
+    }
+  }
+}
+
+void LiveIntervals::insertRegMaskSlots(const MachineInstr &MI) {
+  unsigned MBBNum = MI.getParent()->getNumber();
+  for (const MachineOperand &MO : MI.operands()) {
+    if (!MO.isRegMask())
+      continue;
+    SlotIndex Slot = Indexes->getInstructionIndex(MI).getRegSlot();
+    auto I = std::upper_bound(RegMaskSlots.begin(), RegMaskSlots.end(), Slot);
+    unsigned Pos = I - RegMaskSlots.begin();
+    RegMaskSlots.insert(I, Slot);
+    RegMaskBits.insert(RegMaskBits.begin() + Pos, MO.getRegMask());
+
+    // Shift the slots of the blocks laid out after MI's.
+    for (unsigned N = 0, E = RegMaskBlocks.size(); N != E; ++N) {
+      std::pair<unsigned, unsigned> &RMB = RegMaskBlocks[N];
+      if (N == MBBNum) {
+        if (RMB.second == 0)
+          RMB.first = Pos;
+        ++RMB.second;
+      } else if (RMB.first >= Pos && RMB.second != 0) {
+        ++RMB.first;
+      }
+    }
+  }
+}
+
+void LiveIntervals::removeRegMaskSlots(const MachineInstr &MI) {
+  for (const MachineOperand &MO : MI.operands()) {
+    if (!MO.isRegMask())
+      continue;
+    SlotIndex Slot = Indexes->getInstructionIndex(MI).getRegSlot();
+    auto I = std::lower_bound(RegMaskSlots.begin(), RegMaskSlots.end(), Slot);
+    assert(I != RegMaskSlots.end() && *I == Slot && "Missing regmask slot");
+    unsigned Pos = I - RegMaskSlots.begin();
+    RegMaskSlots.erase(I);
+    RegMaskBits.erase(RegMaskBits.begin() + Pos);
+
+    for (std::pair<unsigned, unsigned> &RMB : RegMaskBlocks) {
+      if (RMB.first <= Pos && Pos < RMB.first + RMB.second)
+        --RMB.second;
+      else if (RMB.first > Pos && RMB.second != 0)
+        --RMB.first;
+    }
+  }
+}
+
+/// Return true if \p A and \p B cover the same slots with the same segments.
+static bool haveSameSegments(const LiveRange &A, const LiveRange &B) {
+  return A.size() == B.size() && std::equal(A.begin(), A.end(), B.begin());
+}
+
+LLVM_ATTRIBUTE_NORETURN static void
+reportLivenessMismatch(const char *Banner, const Twine &Name,
+                       const LiveRange &Updated, const LiveRange &Computed) {
+  std::string Msg;
+  raw_string_ostream OS(Msg);
+  OS << Banner << ": live range of " << Name
+     << " differs from a computation from scratch\n  updated:  " << Updated
+     << "\n  computed: " << Computed;
+  report_fatal_error(OS.str());
+}
+
+void LiveIntervals::verifyVirtRegInterval(unsigned Reg, const char *Banner) {
+  const LiveInterval &LI = getInterval(Reg);
+  LiveInterval NewLI(Reg, LI.weight);
+  if (!MRI->reg_nodbg_empty(Reg)) {
+    // Like computeVirtRegInterval(), but without updating the flags of the
+    // instructions.
+    LRCalc->reset(MF, getSlotIndexes(), DomTree, &getVNInfoAllocator());
+    LRCalc->calculate(NewLI, MRI->shouldTrackSubRegLiveness(Reg));
+    for (VNInfo *VNI : NewLI.valnos) {
+      if (VNI->isUnused() || !VNI->isPHIDef())
+        continue;
+      LiveRange::iterator I = NewLI.FindSegmentContaining(VNI->def);
+      if (I->end == VNI->def.getDeadSlot()) {
+        VNI->markUnused();
+        NewLI.removeSegment(I);
+      }
+    }
+  }
+  // Only the main range is compared: subranges may be split at different
+  // lane masks without being wrong.
+  if (!haveSameSegments(LI, NewLI)) {
+    std::string Name;
+    raw_string_ostream(Name) << printReg(Reg);
+    reportLivenessMismatch(Banner, Name, LI, NewLI);
+  }
+}
+
+void LiveIntervals::verifyRegUnitRange(unsigned Unit, const char *Banner) {
+  const LiveRange *LR = getCachedRegUnit(Unit);
+  if (!LR)
+    return;
+  LiveRange NewLR(UseSegmentSetForPhysRegs);
+  computeRegUnitRangeWithLiveIns(NewLR, Unit);
+  if (!haveSameSegments(*LR, NewLR)) {
+    std::string Name;
+    raw_string_ostream(Name) << printRegUnit(Unit, TRI);
+    reportLivenessMismatch(Banner, Name, *LR, NewLR);
+  }
+}
+
+void LiveIntervals::verifyRegs(ArrayRef<unsigned> Regs, const char *Banner) {
+  for (unsigned Reg : Regs) {
+    if (TargetRegisterInfo::isVirtualRegister(Reg)) {
+      if (hasInterval(Reg))
+        verifyVirtRegInterval(Reg, Banner);
+      continue;
+    }
+    for (MCRegUnitIterator Units(Reg, TRI); Units.isValid(); ++Units)
+      verifyRegUnitRange(*Units, Banner);
+  }
+}
+
+void LiveIntervals::verifyIntervals(const char *Banner) {
+  for (unsigned I = 0, E = MRI->getNumVirtRegs(); I != E; ++I) {
+    unsigned Reg = TargetRegisterInfo::index2VirtReg(I);
+    if (hasInterval(Reg))
+      verifyVirtRegInterval(Reg, Banner);
+  }
+  for (unsigned Unit = 0, E = RegUnitRanges.size(); Unit != E; ++Unit)
+    verifyRegUnitRange(Unit, Banner);
 }
 
 void LiveIntervals::handleMoveIntoBundle(MachineInstr &MI,
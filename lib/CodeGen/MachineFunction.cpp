@@ -20,6 +20,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Analysis/ConstantFolding.h"
@@ -77,6 +78,11 @@ using namespace llvm;
 
 #define DEBUG_TYPE "codegen"
 
+STATISTIC(MaxBytesAllocated,
+          "Maximum bytes allocated by the allocator of a function");
+STATISTIC(MaxAllocatorMemory,
+          "Maximum bytes of slabs held by the allocator of a function");
+
 static cl::opt<unsigned>
 AlignAllFunctions("align-all-functions",
                   cl::desc("Force the alignment of all functions."),
@@ -129,7 +135,8 @@ static inline unsigned getFnStackAlignment(const TargetSubtargetInfo *STI,
 MachineFunction::MachineFunction(const Function &F, const TargetMachine &Target,
                                  const TargetSubtargetInfo &STI,
                                  unsigned FunctionNum, MachineModuleInfo &mmi)
-    : F(F), Target(Target), STI(&STI), Ctx(mmi.getContext()), MMI(mmi) {
+    : F(F), Target(Target), STI(&STI), Ctx(mmi.getContext()), MMI(mmi),
+      Allocator(MachineFunctionSlabAllocator(mmi.getFunctionPool())) {
   FunctionNumber = FunctionNum;
   init();
 }
@@ -139,7 +146,7 @@ void MachineFunction::init() {
   Properties.set(MachineFunctionProperties::Property::IsSSA);
   Properties.set(MachineFunctionProperties::Property::TracksLiveness);
   if (STI->getRegisterInfo())
-    RegInfo = new (Allocator) MachineRegisterInfo(this);
+    RegInfo = MMI.getFunctionPool().createRegInfo(this);
   else
     RegInfo = nullptr;
 
@@ -185,6 +192,8 @@ void MachineFunction::init() {
 }
 
 MachineFunction::~MachineFunction() {
+  MaxBytesAllocated.updateMax(Allocator.getBytesAllocated());
+  MaxAllocatorMemory.updateMax(Allocator.getTotalMemory());
   clear();
 }
 
@@ -203,10 +212,8 @@ void MachineFunction::clear() {
   BasicBlockRecycler.clear(Allocator);
   CodeViewAnnotations.clear();
   VariableDbgInfos.clear();
-  if (RegInfo) {
-    RegInfo->~MachineRegisterInfo();
-    Allocator.Deallocate(RegInfo);
-  }
+  if (RegInfo)
+    MMI.getFunctionPool().releaseRegInfo(RegInfo);
   if (MFInfo) {
     MFInfo->~MachineFunctionInfo();
     Allocator.Deallocate(MFInfo);
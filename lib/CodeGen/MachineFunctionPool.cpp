@@ -0,0 +1,90 @@
+//===- MachineFunctionPool.cpp - Memory reused across MachineFunctions ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the MachineFunctionPool class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/MachineFunctionPool.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MathExtras.h"
+#include <cstdlib>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "machine-function-pool"
+
+STATISTIC(NumSlabsAllocated, "Number of allocator slabs allocated");
+STATISTIC(NumSlabsReused, "Number of allocator slabs reused");
+STATISTIC(NumRegInfosReused, "Number of MachineRegisterInfos reused");
+STATISTIC(MaxPooledMemory, "Maximum bytes of slabs held by the pool");
+
+static cl::opt<unsigned> PoolSizeLimit(
+    "machine-function-pool-limit", cl::Hidden, cl::init(16384),
+    cl::desc("Maximum kilobytes of allocator slabs that MachineFunctions "
+             "leave for later ones (0 = do not reuse memory)"));
+
+MachineFunctionPool::MachineFunctionPool() = default;
+
+MachineFunctionPool::~MachineFunctionPool() { clear(); }
+
+void *MachineFunctionPool::allocateSlab(size_t Size) {
+  auto I = FreeSlabs.find(Size);
+  if (I != FreeSlabs.end() && !I->second.empty()) {
+    void *Slab = I->second.back();
+    I->second.pop_back();
+    PooledMemory -= Size;
+    ++NumSlabsReused;
+    return Slab;
+  }
+  ++NumSlabsAllocated;
+  return safe_malloc(Size);
+}
+
+void MachineFunctionPool::releaseSlab(const void *Slab, size_t Size) {
+  // Only keep slabs of the sizes BumpPtrAllocator asks for on its own. The
+  // ones it allocates for large objects are unlikely to be asked for again.
+  if (!isPowerOf2_64(Size) ||
+      PooledMemory + Size > size_t(PoolSizeLimit) * 1024) {
+    free(const_cast<void *>(Slab));
+    return;
+  }
+  FreeSlabs[Size].push_back(const_cast<void *>(Slab));
+  PooledMemory += Size;
+  MaxPooledMemory.updateMax(PooledMemory);
+}
+
+MachineRegisterInfo *MachineFunctionPool::createRegInfo(MachineFunction *MF) {
+  if (FreeRegInfos.empty())
+    return new MachineRegisterInfo(MF);
+  MachineRegisterInfo *MRI = FreeRegInfos.back().release();
+  FreeRegInfos.pop_back();
+  MRI->reset(MF);
+  ++NumRegInfosReused;
+  return MRI;
+}
+
+void MachineFunctionPool::releaseRegInfo(MachineRegisterInfo *MRI) {
+  if (PoolSizeLimit == 0) {
+    delete MRI;
+    return;
+  }
+  FreeRegInfos.emplace_back(MRI);
+}
+
+void MachineFunctionPool::clear() {
+  for (auto &Entry : FreeSlabs)
+    for (void *Slab : Entry.second)
+      free(Slab);
+  FreeSlabs.clear();
+  PooledMemory = 0;
+  FreeRegInfos.clear();
+}
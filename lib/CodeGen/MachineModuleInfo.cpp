@@ -224,6 +224,8 @@ bool MachineModuleInfo::doFinalization(Module &M) {
   delete ObjFileMMI;
   ObjFileMMI = nullptr;
 
+  FunctionPool.clear();
+
   return false;
 }
 
@@ -32,6 +32,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace llvm;
@@ -53,6 +54,33 @@ MachineRegisterInfo::MachineRegisterInfo(MachineFunction *MF)
   PhysRegUseDefLists.reset(new MachineOperand*[NumRegs]());
 }
 
+void MachineRegisterInfo::reset(MachineFunction *NewMF) {
+  unsigned OldNumRegs = UsedPhysRegMask.size();
+  MF = NewMF;
+  TheDelegate = nullptr;
+  TracksSubRegLiveness =
+      MF->getSubtarget().enableSubRegLiveness() && EnableSubRegLiveness;
+  VRegInfo.clear();
+  VReg2Name.clear();
+  VRegNames.clear();
+  IsUpdatedCSRsInitialized = false;
+  UpdatedCSRs.clear();
+  RegAllocHints.clear();
+  ReservedRegs.clear();
+  VRegToType.clear();
+  LiveIns.clear();
+
+  // The instructions of the previous function were dropped without being
+  // unlinked from the use/def lists, so the heads must be cleared.
+  unsigned NumRegs = getTargetRegisterInfo()->getNumRegs();
+  UsedPhysRegMask.clear();
+  UsedPhysRegMask.resize(NumRegs);
+  if (NumRegs == OldNumRegs)
+    std::fill_n(PhysRegUseDefLists.get(), NumRegs, nullptr);
+  else
+    PhysRegUseDefLists.reset(new MachineOperand*[NumRegs]());
+}
+
 /// setRegClass - Set the register class of the specified virtual register.
 ///
 void
@@ -386,6 +386,8 @@ bool MachineScheduler::runOnMachineFunction(MachineFunction &mf) {
   LLVM_DEBUG(LIS->dump());
   if (VerifyScheduling)
     MF->verify(this, "After machine scheduling.");
+  if (VerifyLivenessUpdates)
+    LIS->verifyIntervals("After machine scheduling");
   return true;
 }
 
@@ -3187,6 +3187,8 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   allocatePhysRegs();
   tryHintsRecoloring();
   postOptimization();
+  if (VerifyLivenessUpdates)
+    LIS->verifyIntervals("After greedy register allocation");
   reportNumberOfSplillsReloads();
 
   releaseMemory();
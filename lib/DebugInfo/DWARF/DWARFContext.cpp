@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
@@ -44,6 +45,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -584,9 +586,73 @@ DWARFDie DWARFContext::getDIEForOffset(uint32_t Offset) {
   return DWARFDie();
 }
 
-bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts) {
+void DWARFContext::extractCompileUnits(unsigned NumThreads) {
+  // Everything shared between units is set up lazily, so do it here before
+  // starting the threads. Parsing a unit DIE also reads the abbreviations,
+  // string offsets and range list table header of the unit.
+  getDebugLoc();
+  for (const auto &CU : compile_units()) {
+    CU->getUnitDIE();
+    CU->getBaseAddress();
+  }
+
+  ThreadPool Pool(NumThreads);
+  for (const auto &CU : compile_units()) {
+    DWARFCompileUnit *U = CU.get();
+    Pool.async([U] { U->extractDIEsIfNeeded(false); });
+  }
+  Pool.wait();
+}
+
+void DWARFContext::parseLineTables(unsigned NumThreads) {
+  if (!Line)
+    Line.reset(new DWARFDebugLine);
+
+  struct PendingTable {
+    PendingTable(DWARFUnit *U, uint32_t Offset) : U(U), Offset(Offset) {}
+
+    DWARFUnit *U;
+    uint32_t Offset;
+    DWARFDebugLine::LineTable LT;
+    bool Failed = false;
+  };
+  std::vector<PendingTable> Tables;
+  DenseSet<uint32_t> Offsets;
+  for (const auto &CU : compile_units()) {
+    auto Offset = toSectionOffset(CU->getUnitDIE().find(DW_AT_stmt_list));
+    if (!Offset)
+      continue;
+    uint32_t StmtOffset = *Offset + CU->getLineTableOffset();
+    if (StmtOffset >= CU->getLineSection().Data.size() ||
+        Line->getLineTable(StmtOffset) || !Offsets.insert(StmtOffset).second)
+      continue;
+    Tables.emplace_back(CU.get(), StmtOffset);
+  }
+
+  ThreadPool Pool(NumThreads);
+  for (PendingTable &T : Tables)
+    Pool.async([this, &T] {
+      DWARFDataExtractor LineData(*DObj, T.U->getLineSection(),
+                                  isLittleEndian(), T.U->getAddressByteSize());
+      uint32_t Offset = T.Offset;
+      auto Fail = [&T](Error E) {
+        consumeError(std::move(E));
+        T.Failed = true;
+      };
+      if (Error E = T.LT.parse(LineData, &Offset, *this, T.U, Fail))
+        Fail(std::move(E));
+    });
+  Pool.wait();
+
+  for (PendingTable &T : Tables)
+    if (!T.Failed)
+      Line->insertLineTable(T.Offset, std::move(T.LT));
+}
+
+bool DWARFContext::verify(raw_ostream &OS, DIDumpOptions DumpOpts,
+                          unsigned NumThreads) {
   bool Success = true;
-  DWARFVerifier verifier(OS, *this, DumpOpts);
+  DWARFVerifier verifier(OS, *this, DumpOpts, NumThreads);
 
   Success &= verifier.handleDebugAbbrev();
   if (DumpOpts.DumpType & DIDT_DebugInfo)
@@ -156,9 +156,11 @@ parseV2DirFileTables(const DWARFDataExtractor &DebugLineData,
     DWARFDebugLine::FileNameEntry FileEntry;
     FileEntry.Name.setForm(dwarf::DW_FORM_string);
     FileEntry.Name.setPValue(Name.data());
-    FileEntry.DirIdx = DebugLineData.getULEB128(OffsetPtr);
-    FileEntry.ModTime = DebugLineData.getULEB128(OffsetPtr);
-    FileEntry.Length = DebugLineData.getULEB128(OffsetPtr);
+    uint64_t Values[3];
+    DebugLineData.getULEB128(OffsetPtr, Values, 3);
+    FileEntry.DirIdx = Values[0];
+    FileEntry.ModTime = Values[1];
+    FileEntry.Length = Values[2];
     FileNames.push_back(FileEntry);
   }
 
@@ -486,6 +488,10 @@ Expected<const DWARFDebugLine::LineTable *> DWARFDebugLine::getOrParseLineTable(
   return LT;
 }
 
+void DWARFDebugLine::insertLineTable(uint32_t Offset, LineTable LT) {
+  LineTableMap.insert(LineTableMapTy::value_type(Offset, std::move(LT)));
+}
+
 Error DWARFDebugLine::LineTable::parse(
     DWARFDataExtractor &DebugLineData, uint32_t *OffsetPtr,
     const DWARFContext &Ctx, const DWARFUnit *U,
@@ -611,9 +617,11 @@ Error DWARFDebugLine::LineTable::parse(
           const char *Name = DebugLineData.getCStr(OffsetPtr);
           FileEntry.Name.setForm(dwarf::DW_FORM_string);
           FileEntry.Name.setPValue(Name);
-          FileEntry.DirIdx = DebugLineData.getULEB128(OffsetPtr);
-          FileEntry.ModTime = DebugLineData.getULEB128(OffsetPtr);
-          FileEntry.Length = DebugLineData.getULEB128(OffsetPtr);
+          uint64_t Values[3];
+          DebugLineData.getULEB128(OffsetPtr, Values, 3);
+          FileEntry.DirIdx = Values[0];
+          FileEntry.ModTime = Values[1];
+          FileEntry.Length = Values[2];
           Prologue.FileNames.push_back(FileEntry);
           if (OS)
             *OS << " (" << Name << ", dir=" << FileEntry.DirIdx << ", mod_time="
@@ -515,6 +515,18 @@ DWARFUnit::getInlinedChainForAddress(uint64_t Address,
   InlinedChain.push_back(SubroutineDIE);
 }
 
+void DWARFUnit::getInlinedChainBoundaries(std::vector<uint64_t> &Boundaries) {
+  parseDWO();
+  DWARFUnit *U = DWO ? DWO.get() : this;
+  U->extractDIEsIfNeeded(false);
+  if (U->AddrDieMap.empty())
+    U->updateAddressDieMap(U->getUnitDIE());
+  for (const auto &Entry : U->AddrDieMap) {
+    Boundaries.push_back(Entry.first);
+    Boundaries.push_back(Entry.second.first);
+  }
+}
+
 const DWARFUnitIndex &llvm::getDWARFUnitIndex(DWARFContext &Context,
                                               DWARFSectionKind Kind) {
   if (Kind == DW_SECT_INFO)
@@ -18,8 +18,10 @@
 #include "llvm/DebugInfo/DWARF/DWARFSection.h"
 #include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
+#include <deque>
 #include <map>
 #include <set>
 #include <vector>
@@ -171,7 +173,7 @@ bool DWARFVerifier::verifyUnitHeader(const DWARFDataExtractor DebugInfoData,
   return Success;
 }
 
-bool DWARFVerifier::verifyUnitContents(DWARFUnit Unit, uint8_t UnitType) {
+bool DWARFVerifier::verifyUnitContents(DWARFUnit &Unit, uint8_t UnitType) {
   uint32_t NumUnitErrors = 0;
   unsigned NumDies = Unit.getNumDIEs();
   for (unsigned I = 0; I < NumDies; ++I) {
@@ -252,6 +254,21 @@ bool DWARFVerifier::handleDebugAbbrev() {
   return NumErrors == 0;
 }
 
+namespace {
+/// A unit being verified on a worker thread. Each unit has a verifier of its
+/// own, writing to a buffer, so that the output can be printed in unit order.
+struct UnitVerification {
+  UnitVerification(DWARFContext &DCtx, const DIDumpOptions &DumpOpts)
+      : OS(Output), Verifier(OS, DCtx, DumpOpts) {}
+
+  std::string Output;
+  raw_string_ostream OS;
+  DWARFVerifier Verifier;
+  std::unique_ptr<DWARFUnit> Unit;
+  bool Failed = false;
+};
+} // end anonymous namespace
+
 bool DWARFVerifier::handleDebugInfo() {
   OS << "Verifying .debug_info Unit Header Chain...\n";
 
@@ -266,10 +283,24 @@ bool DWARFVerifier::handleDebugInfo() {
   bool hasDIE = DebugInfoData.isValidOffset(Offset);
   DWARFUnitSection<DWARFTypeUnit> TUSection{};
   DWARFUnitSection<DWARFCompileUnit> CUSection{};
+
+  // The unit headers are always checked in order on this thread. With more
+  // than one thread, the rest of each unit is checked on the pool.
+  Optional<ThreadPool> Pool;
+  std::deque<UnitVerification> Units;
+  if (NumThreads > 1) {
+    DCtx.getDebugLoc();
+    Pool.emplace(NumThreads);
+  }
   while (hasDIE) {
+    DWARFVerifier *V = this;
+    if (Pool) {
+      Units.emplace_back(DCtx, DumpOpts);
+      V = &Units.back().Verifier;
+    }
     OffsetStart = Offset;
-    if (!verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
-                          isUnitDWARF64)) {
+    if (!V->verifyUnitHeader(DebugInfoData, &Offset, UnitIdx, UnitType,
+                             isUnitDWARF64)) {
       isHeaderChainValid = false;
       if (isUnitDWARF64)
         break;
@@ -303,12 +334,34 @@ bool DWARFVerifier::handleDebugInfo() {
       }
       default: { llvm_unreachable("Invalid UnitType."); }
       }
-      if (!verifyUnitContents(*Unit, UnitType))
+      if (Pool) {
+        // Parsing the unit DIE sets up state shared with other units.
+        Unit->getUnitDIE();
+        UnitVerification &UV = Units.back();
+        UV.Unit = std::move(Unit);
+        Pool->async([&UV, UnitType] {
+          UV.Failed = !UV.Verifier.verifyUnitContents(*UV.Unit, UnitType);
+          UV.Unit.reset();
+        });
+      } else if (!verifyUnitContents(*Unit, UnitType))
         ++NumDebugInfoErrors;
     }
     hasDIE = DebugInfoData.isValidOffset(Offset);
     ++UnitIdx;
   }
+  if (Pool) {
+    Pool->wait();
+    for (UnitVerification &UV : Units) {
+      OS << UV.OS.str();
+      NumDebugInfoErrors += UV.Failed;
+      for (const auto &Pair : UV.Verifier.ReferenceToDIEOffsets)
+        ReferenceToDIEOffsets[Pair.first].insert(Pair.second.begin(),
+                                                 Pair.second.end());
+    }
+    // Looking the references up extracts all the units of the context.
+    if (!ReferenceToDIEOffsets.empty())
+      DCtx.extractCompileUnits(NumThreads);
+  }
   if (UnitIdx == 0 && !hasDIE) {
     warn() << ".debug_info is empty.\n";
     isHeaderChainValid = true;
@@ -667,6 +720,8 @@ void DWARFVerifier::verifyDebugLineRows() {
 bool DWARFVerifier::handleDebugLine() {
   NumDebugLineErrors = 0;
   OS << "Verifying .debug_line...\n";
+  if (NumThreads > 1)
+    DCtx.parseLineTables(NumThreads);
   verifyDebugLineStmtOffsets();
   verifyDebugLineRows();
   return NumDebugLineErrors == 0;
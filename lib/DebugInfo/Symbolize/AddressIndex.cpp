@@ -0,0 +1,332 @@
+//===- AddressIndex.cpp ---------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementation of the symbolizer's address index.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/DebugInfo/Symbolize/AddressIndex.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+
+using namespace llvm;
+using namespace symbolize;
+
+// The index file is little-endian:
+//
+//   "LLVMSIDX" <version:u32>
+//   <key size:u32> <key bytes>
+//   <string count:u32> <offsets:u32 x (count + 1)> <string bytes>
+//   <frame count:u32> <frames:u32 x 7 x count>
+//   <chain frame count:u32> <chain frames:u32 x count>
+//   <chain count:u32> <chain starts:u32 x (count + 1)>
+//   <range count:u32> <ranges:(u64, u32, u32) x count>
+static const char IndexMagic[] = "LLVMSIDX";
+static const uint32_t IndexVersion = 1;
+
+const uint32_t AddressIndex::NoRange;
+const uint32_t AddressIndex::NoSource;
+
+std::unique_ptr<AddressIndex>
+AddressIndex::build(std::vector<uint64_t> Boundaries,
+                    InlinedCodeFn SymbolizeInlinedCode, CodeFn SymbolizeCode) {
+  llvm::sort(Boundaries.begin(), Boundaries.end());
+  Boundaries.erase(std::unique(Boundaries.begin(), Boundaries.end()),
+                   Boundaries.end());
+
+  std::unique_ptr<AddressIndex> Index(new AddressIndex());
+  Index->StringOffsets.push_back(0);
+  Index->ChainStarts.push_back(0);
+
+  // Each distinct string, frame and chain is stored once.
+  StringMap<uint32_t> StringIds;
+  auto AddString = [&](StringRef S) -> uint32_t {
+    auto Result = StringIds.insert({S, Index->StringOffsets.size() - 1});
+    if (Result.second) {
+      Index->StringData += S;
+      Index->StringOffsets.push_back(Index->StringData.size());
+    }
+    return Result.first->second;
+  };
+
+  using FrameKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t,
+                              uint32_t, uint32_t, uint32_t>;
+  std::map<FrameKey, uint32_t> FrameIds;
+  auto AddFrame = [&](const DILineInfo &Info) -> uint32_t {
+    Frame F;
+    F.FunctionName = AddString(Info.FunctionName);
+    F.FileName = AddString(Info.FileName);
+    F.Source = Info.Source ? AddString(*Info.Source) : NoSource;
+    F.Line = Info.Line;
+    F.Column = Info.Column;
+    F.StartLine = Info.StartLine;
+    F.Discriminator = Info.Discriminator;
+    FrameKey Key(F.FunctionName, F.FileName, F.Source, F.Line, F.Column,
+                 F.StartLine, F.Discriminator);
+    auto Result = FrameIds.insert({Key, Index->Frames.size()});
+    if (Result.second)
+      Index->Frames.push_back(F);
+    return Result.first->second;
+  };
+
+  std::map<std::vector<uint32_t>, uint32_t> ChainIds;
+  auto AddChain = [&](const std::vector<uint32_t> &Chain) -> uint32_t {
+    auto Result = ChainIds.insert({Chain, Index->ChainStarts.size() - 1});
+    if (Result.second) {
+      Index->ChainFrames.insert(Index->ChainFrames.end(), Chain.begin(),
+                                Chain.end());
+      Index->ChainStarts.push_back(Index->ChainFrames.size());
+    }
+    return Result.first->second;
+  };
+
+  std::vector<uint32_t> Chain;
+  for (size_t I = 0; I + 1 < Boundaries.size(); ++I) {
+    uint64_t Address = Boundaries[I];
+    DIInliningInfo InlinedContext = SymbolizeInlinedCode(Address);
+    Chain.clear();
+    for (uint32_t F = 0, N = InlinedContext.getNumberOfFrames(); F != N; ++F)
+      Chain.push_back(AddFrame(InlinedContext.getFrame(F)));
+    uint32_t ChainId = AddChain(Chain);
+    uint32_t CodeId =
+        Chain.size() == 1 ? Chain[0] : AddFrame(SymbolizeCode(Address));
+
+    // Neighbouring ranges often give the same answer, e.g. when only the
+    // is_stmt flag of a line table row differs.
+    if (!Index->Ranges.empty() && Index->Ranges.back().Chain == ChainId &&
+        Index->Ranges.back().Code == CodeId)
+      continue;
+    Index->Ranges.push_back({Address, ChainId, CodeId});
+  }
+  if (!Index->Ranges.empty())
+    Index->Ranges.push_back({Boundaries.back(), NoRange, NoRange});
+  return Index;
+}
+
+const AddressIndex::Range *AddressIndex::findRange(uint64_t Address) const {
+  auto I = std::upper_bound(
+      Ranges.begin(), Ranges.end(), Address,
+      [](uint64_t Address, const Range &R) { return Address < R.Start; });
+  if (I == Ranges.begin())
+    return nullptr;
+  --I;
+  if (I->Chain == NoRange)
+    return nullptr;
+  return &*I;
+}
+
+StringRef AddressIndex::getString(uint32_t I) const {
+  return StringRef(StringData.data() + StringOffsets[I],
+                   StringOffsets[I + 1] - StringOffsets[I]);
+}
+
+DILineInfo AddressIndex::getFrame(uint32_t I) const {
+  const Frame &F = Frames[I];
+  DILineInfo Info;
+  Info.FunctionName = getString(F.FunctionName);
+  Info.FileName = getString(F.FileName);
+  if (F.Source != NoSource)
+    Info.Source = getString(F.Source);
+  Info.Line = F.Line;
+  Info.Column = F.Column;
+  Info.StartLine = F.StartLine;
+  Info.Discriminator = F.Discriminator;
+  return Info;
+}
+
+bool AddressIndex::lookupInlinedCode(uint64_t Address,
+                                     DIInliningInfo &Result) const {
+  const Range *R = findRange(Address);
+  if (!R)
+    return false;
+  Result = DIInliningInfo();
+  for (uint32_t I = ChainStarts[R->Chain], E = ChainStarts[R->Chain + 1];
+       I != E; ++I)
+    Result.addFrame(getFrame(ChainFrames[I]));
+  return true;
+}
+
+bool AddressIndex::lookupCode(uint64_t Address, DILineInfo &Result) const {
+  const Range *R = findRange(Address);
+  if (!R)
+    return false;
+  Result = getFrame(R->Code);
+  return true;
+}
+
+static Error malformedIndex(StringRef Path) {
+  return make_error<StringError>("malformed address index " + Path,
+                                 inconvertibleErrorCode());
+}
+
+Expected<std::unique_ptr<AddressIndex>> AddressIndex::load(StringRef Path,
+                                                           StringRef Key) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!MBOrErr)
+    return errorCodeToError(MBOrErr.getError());
+  StringRef Buffer = (*MBOrErr)->getBuffer();
+  if (Buffer.size() >= std::numeric_limits<uint32_t>::max() ||
+      !Buffer.startswith(StringRef(IndexMagic, 8)))
+    return malformedIndex(Path);
+
+  DataExtractor Data(Buffer, /*IsLittleEndian=*/true, 8);
+  uint32_t Offset = 8;
+  if (Data.getU32(&Offset) != IndexVersion)
+    return malformedIndex(Path);
+  uint32_t KeySize = Data.getU32(&Offset);
+  if (!Data.isValidOffsetForDataOfSize(Offset, KeySize) ||
+      Buffer.substr(Offset, KeySize) != Key)
+    return make_error<StringError>("address index " + Path + " is stale",
+                                   inconvertibleErrorCode());
+  Offset += KeySize;
+
+  // Read a count followed by that many elements of ElementSize bytes each,
+  // making sure they are all in the buffer before allocating anything.
+  auto ReadCount = [&](uint32_t ElementSize, uint32_t Extra,
+                       uint32_t &Count) {
+    Count = Data.getU32(&Offset);
+    uint64_t Size = (uint64_t(Count) + Extra) * ElementSize;
+    return Size <= Buffer.size() &&
+           Data.isValidOffsetForDataOfSize(Offset, Size);
+  };
+
+  std::unique_ptr<AddressIndex> Index(new AddressIndex());
+  uint32_t NumStrings;
+  if (!ReadCount(4, 1, NumStrings))
+    return malformedIndex(Path);
+  Index->StringOffsets.resize(NumStrings + 1);
+  Data.getU32(&Offset, Index->StringOffsets.data(), NumStrings + 1);
+  uint32_t StringSize = Index->StringOffsets.back();
+  if (!Data.isValidOffsetForDataOfSize(Offset, StringSize) ||
+      Index->StringOffsets.front() != 0 ||
+      !std::is_sorted(Index->StringOffsets.begin(),
+                      Index->StringOffsets.end()))
+    return malformedIndex(Path);
+  Index->StringData = Buffer.substr(Offset, StringSize).str();
+  Offset += StringSize;
+
+  uint32_t NumFrames;
+  if (!ReadCount(7 * 4, 0, NumFrames))
+    return malformedIndex(Path);
+  Index->Frames.resize(NumFrames);
+  for (Frame &F : Index->Frames) {
+    F.FunctionName = Data.getU32(&Offset);
+    F.FileName = Data.getU32(&Offset);
+    F.Source = Data.getU32(&Offset);
+    F.Line = Data.getU32(&Offset);
+    F.Column = Data.getU32(&Offset);
+    F.StartLine = Data.getU32(&Offset);
+    F.Discriminator = Data.getU32(&Offset);
+    if (F.FunctionName >= NumStrings || F.FileName >= NumStrings ||
+        (F.Source != NoSource && F.Source >= NumStrings))
+      return malformedIndex(Path);
+  }
+
+  uint32_t NumChainFrames;
+  if (!ReadCount(4, 0, NumChainFrames))
+    return malformedIndex(Path);
+  Index->ChainFrames.resize(NumChainFrames);
+  Data.getU32(&Offset, Index->ChainFrames.data(), NumChainFrames);
+  if (std::any_of(Index->ChainFrames.begin(), Index->ChainFrames.end(),
+                  [&](uint32_t F) { return F >= NumFrames; }))
+    return malformedIndex(Path);
+
+  uint32_t NumChains;
+  if (!ReadCount(4, 1, NumChains))
+    return malformedIndex(Path);
+  Index->ChainStarts.resize(NumChains + 1);
+  Data.getU32(&Offset, Index->ChainStarts.data(), NumChains + 1);
+  if (Index->ChainStarts.front() != 0 ||
+      Index->ChainStarts.back() != NumChainFrames ||
+      !std::is_sorted(Index->ChainStarts.begin(), Index->ChainStarts.end()))
+    return malformedIndex(Path);
+
+  uint32_t NumRanges;
+  if (!ReadCount(8 + 4 + 4, 0, NumRanges))
+    return malformedIndex(Path);
+  Index->Ranges.resize(NumRanges);
+  for (Range &R : Index->Ranges) {
+    R.Start = Data.getU64(&Offset);
+    R.Chain = Data.getU32(&Offset);
+    R.Code = Data.getU32(&Offset);
+    if (R.Chain != NoRange && (R.Chain >= NumChains || R.Code >= NumFrames))
+      return malformedIndex(Path);
+  }
+  if (Offset != Buffer.size() ||
+      (!Index->Ranges.empty() && Index->Ranges.back().Chain != NoRange) ||
+      !std::is_sorted(Index->Ranges.begin(), Index->Ranges.end(),
+                      [](const Range &LHS, const Range &RHS) {
+                        return LHS.Start < RHS.Start;
+                      }))
+    return malformedIndex(Path);
+  return std::move(Index);
+}
+
+Error AddressIndex::save(StringRef Path, StringRef Key) const {
+  SmallString<128> TempPath;
+  int FD;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + "-%%%%%%.tmp", FD, TempPath))
+    return errorCodeToError(EC);
+
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    support::endian::Writer W(OS, support::little);
+    OS << StringRef(IndexMagic, 8);
+    W.write<uint32_t>(IndexVersion);
+    W.write<uint32_t>(Key.size());
+    OS << Key;
+    W.write<uint32_t>(StringOffsets.size() - 1);
+    W.write(makeArrayRef(StringOffsets));
+    OS << StringData;
+    W.write<uint32_t>(Frames.size());
+    for (const Frame &F : Frames) {
+      W.write<uint32_t>(F.FunctionName);
+      W.write<uint32_t>(F.FileName);
+      W.write<uint32_t>(F.Source);
+      W.write<uint32_t>(F.Line);
+      W.write<uint32_t>(F.Column);
+      W.write<uint32_t>(F.StartLine);
+      W.write<uint32_t>(F.Discriminator);
+    }
+    W.write<uint32_t>(ChainFrames.size());
+    W.write(makeArrayRef(ChainFrames));
+    W.write<uint32_t>(ChainStarts.size() - 1);
+    W.write(makeArrayRef(ChainStarts));
+    W.write<uint32_t>(Ranges.size());
+    for (const Range &R : Ranges) {
+      W.write<uint64_t>(R.Start);
+      W.write<uint32_t>(R.Chain);
+      W.write<uint32_t>(R.Code);
+    }
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return make_error<StringError>("cannot write " + TempPath,
+                                     inconvertibleErrorCode());
+    }
+  }
+
+  if (std::error_code EC = sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    return errorCodeToError(EC);
+  }
+  return Error::success();
+}
@@ -17,6 +17,7 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugArangeSet.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/COFF.h"
 #include "llvm/Object/ObjectFile.h"
@@ -269,3 +270,56 @@ DIGlobal SymbolizableObjectFile::symbolizeData(uint64_t ModuleOffset) const {
                          Res.Size);
   return Res;
 }
+
+bool SymbolizableObjectFile::getCodeBoundaries(
+    std::vector<uint64_t> &Boundaries) const {
+  // Only DWARF can enumerate where its answers change.
+  auto *DICtx = dyn_cast_or_null<DWARFContext>(DebugInfoContext.get());
+  if (!DICtx)
+    return false;
+
+  // The compile unit for an address comes from .debug_aranges where present,
+  // and from the unit DIEs otherwise.
+  DataExtractor ArangesData(DICtx->getDWARFObj().getARangeSection(),
+                            DICtx->isLittleEndian(), 0);
+  uint32_t Offset = 0;
+  DWARFDebugArangeSet Set;
+  while (Set.extract(ArangesData, &Offset)) {
+    for (const auto &Desc : Set.descriptors()) {
+      Boundaries.push_back(Desc.Address);
+      Boundaries.push_back(Desc.getEndAddress());
+    }
+  }
+
+  for (const auto &CU : DICtx->compile_units()) {
+    DWARFAddressRangesVector CURanges;
+    CU->collectAddressRanges(CURanges);
+    for (const auto &R : CURanges) {
+      Boundaries.push_back(R.LowPC);
+      Boundaries.push_back(R.HighPC);
+    }
+    // Within a unit, the frames change with the line table rows and with the
+    // subprogram and inlined subroutine DIEs.
+    if (const DWARFDebugLine::LineTable *LineTable =
+            DICtx->getLineTableForUnit(CU.get())) {
+      const DWARFDebugLine::Row *Prev = nullptr;
+      for (const DWARFDebugLine::Row &Row : LineTable->Rows) {
+        Boundaries.push_back(Row.Address);
+        // Where rows share an address, a lookup of that exact address finds
+        // the first one and a lookup past it finds the last one.
+        if (Prev && Prev->Address == Row.Address)
+          Boundaries.push_back(Row.Address + 1);
+        Prev = &Row;
+      }
+    }
+    CU->getInlinedChainBoundaries(Boundaries);
+  }
+
+  // The outermost function name may come from the symbol table.
+  for (const auto &Function : Functions) {
+    Boundaries.push_back(Function.first.Addr);
+    if (Function.first.Size != 0)
+      Boundaries.push_back(Function.first.Addr + Function.first.Size);
+  }
+  return true;
+}
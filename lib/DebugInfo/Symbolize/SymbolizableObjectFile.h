@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <system_error>
+#include <vector>
 
 namespace llvm {
 
@@ -40,6 +41,7 @@ public:
                                       FunctionNameKind FNKind,
                                       bool UseSymbolTable) const override;
   DIGlobal symbolizeData(uint64_t ModuleOffset) const override;
+  bool getCodeBoundaries(std::vector<uint64_t> &Boundaries) const override;
 
   // Return true if this is a 32-bit x86 PE COFF module.
   bool isWin32Module() const override;
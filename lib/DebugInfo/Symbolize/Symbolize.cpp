@@ -32,6 +32,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
@@ -72,6 +73,17 @@ LLVMSymbolizer::symbolizeCode(const std::string &ModuleName,
   if (Opts.RelativeAddresses)
     ModuleOffset += Info->getModulePreferredBase();
 
+  if (AddressIndex *Index =
+          getOrCreateAddressIndex(ModuleName, Info, DWPName)) {
+    DILineInfo LineInfo;
+    if (Index->lookupCode(ModuleOffset, LineInfo))
+      return LineInfo;
+  }
+  return symbolizeCodeInModule(Info, ModuleOffset);
+}
+
+DILineInfo LLVMSymbolizer::symbolizeCodeInModule(SymbolizableModule *Info,
+                                                 uint64_t ModuleOffset) {
   DILineInfo LineInfo = Info->symbolizeCode(ModuleOffset, Opts.PrintFunctions,
                                             Opts.UseSymbolTable);
   if (Opts.Demangle)
@@ -98,6 +110,18 @@ LLVMSymbolizer::symbolizeInlinedCode(const std::string &ModuleName,
   if (Opts.RelativeAddresses)
     ModuleOffset += Info->getModulePreferredBase();
 
+  if (AddressIndex *Index =
+          getOrCreateAddressIndex(ModuleName, Info, DWPName)) {
+    DIInliningInfo InlinedContext;
+    if (Index->lookupInlinedCode(ModuleOffset, InlinedContext))
+      return InlinedContext;
+  }
+  return symbolizeInlinedCodeInModule(Info, ModuleOffset);
+}
+
+DIInliningInfo
+LLVMSymbolizer::symbolizeInlinedCodeInModule(SymbolizableModule *Info,
+                                             uint64_t ModuleOffset) {
   DIInliningInfo InlinedContext = Info->symbolizeInlinedCode(
       ModuleOffset, Opts.PrintFunctions, Opts.UseSymbolTable);
   if (Opts.Demangle) {
@@ -139,6 +163,7 @@ void LLVMSymbolizer::flush() {
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
+  AddressIndexes.clear();
 }
 
 namespace {
@@ -364,15 +389,13 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
   return errorCodeToError(object_error::arch_not_found);
 }
 
-Expected<SymbolizableModule *>
-LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
-                                      StringRef DWPName) {
-  const auto &I = Modules.find(ModuleName);
-  if (I != Modules.end()) {
-    return I->second.get();
-  }
-  std::string BinaryName = ModuleName;
-  std::string ArchName = Opts.DefaultArch;
+// Split a module name of the form "path[:arch]".
+static void getBinaryAndArchName(const std::string &ModuleName,
+                                 const std::string &DefaultArch,
+                                 std::string &BinaryName,
+                                 std::string &ArchName) {
+  BinaryName = ModuleName;
+  ArchName = DefaultArch;
   size_t ColonPos = ModuleName.find_last_of(':');
   // Verify that substring after colon form a valid arch name.
   if (ColonPos != std::string::npos) {
@@ -382,6 +405,17 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
       ArchName = ArchStr;
     }
   }
+}
+
+Expected<SymbolizableModule *>
+LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
+                                      StringRef DWPName) {
+  const auto &I = Modules.find(ModuleName);
+  if (I != Modules.end()) {
+    return I->second.get();
+  }
+  std::string BinaryName, ArchName;
+  getBinaryAndArchName(ModuleName, Opts.DefaultArch, BinaryName, ArchName);
   auto ObjectsOrErr = getOrCreateObjectPair(BinaryName, ArchName);
   if (!ObjectsOrErr) {
     // Failed to find valid object file.
@@ -427,6 +461,61 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName,
   return InsertResult.first->second.get();
 }
 
+AddressIndex *
+LLVMSymbolizer::getOrCreateAddressIndex(const std::string &ModuleName,
+                                        SymbolizableModule *Info,
+                                        StringRef DWPName) {
+  if (!Opts.UseAddressIndex)
+    return nullptr;
+  const auto &I = AddressIndexes.find(ModuleName);
+  if (I != AddressIndexes.end())
+    return I->second.get();
+  std::unique_ptr<AddressIndex> &Index = AddressIndexes[ModuleName];
+
+  // A saved index is only used if it was built from the same binary with the
+  // same options. Changes to separate debug info files aren't detected.
+  std::string IndexPath, Key;
+  if (Opts.PersistAddressIndex) {
+    std::string BinaryName, ArchName;
+    getBinaryAndArchName(ModuleName, Opts.DefaultArch, BinaryName, ArchName);
+    sys::fs::file_status Status;
+    if (!sys::fs::status(BinaryName, Status)) {
+      IndexPath = BinaryName;
+      if (!ArchName.empty())
+        IndexPath += "." + ArchName;
+      IndexPath += ".llvm-symidx";
+      raw_string_ostream KeyOS(Key);
+      KeyOS << "size=" << Status.getSize() << " mtime="
+            << Status.getLastModificationTime().time_since_epoch().count()
+            << " functions=" << static_cast<int>(Opts.PrintFunctions)
+            << " symtab=" << Opts.UseSymbolTable
+            << " demangle=" << Opts.Demangle << " dwp=" << DWPName;
+      KeyOS.flush();
+      Expected<std::unique_ptr<AddressIndex>> IndexOrErr =
+          AddressIndex::load(IndexPath, Key);
+      if (IndexOrErr) {
+        Index = std::move(*IndexOrErr);
+        return Index.get();
+      }
+      consumeError(IndexOrErr.takeError());
+    }
+  }
+
+  std::vector<uint64_t> Boundaries;
+  if (!Info->getCodeBoundaries(Boundaries))
+    return nullptr;
+  Index = AddressIndex::build(
+      std::move(Boundaries),
+      [&](uint64_t Address) {
+        return symbolizeInlinedCodeInModule(Info, Address);
+      },
+      [&](uint64_t Address) { return symbolizeCodeInModule(Info, Address); });
+  // Saving is best effort: the binary may be in a read-only directory.
+  if (!IndexPath.empty())
+    consumeError(Index->save(IndexPath, Key));
+  return Index.get();
+}
+
 namespace {
 
 // Undo these various manglings for Win32 extern "C" functions:
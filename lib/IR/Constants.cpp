@@ -598,7 +598,10 @@ Constant *ConstantInt::getFalse(Type *Ty) {
 ConstantInt *ConstantInt::get(LLVMContext &Context, const APInt &V) {
   // get an existing value or the insertion position
   LLVMContextImpl *pImpl = Context.pImpl;
-  std::unique_ptr<ConstantInt> &Slot = pImpl->IntConstants[V];
+  auto &Shard =
+      pImpl->IntConstants.getShard(DenseMapAPIntKeyInfo::getHashValue(V));
+  auto Lock = pImpl->lockIfConcurrent(Shard.Lock);
+  std::unique_ptr<ConstantInt> &Slot = Shard.Map[V];
   if (!Slot) {
     // Get the corresponding integer type for the bit width of the value.
     IntegerType *ITy = IntegerType::get(Context, V.getBitWidth());
@@ -747,7 +750,10 @@ Constant *ConstantFP::getZeroValueForNegation(Type *Ty) {
 ConstantFP* ConstantFP::get(LLVMContext &Context, const APFloat& V) {
   LLVMContextImpl* pImpl = Context.pImpl;
 
-  std::unique_ptr<ConstantFP> &Slot = pImpl->FPConstants[V];
+  auto &Shard =
+      pImpl->FPConstants.getShard(DenseMapAPFloatKeyInfo::getHashValue(V));
+  auto Lock = pImpl->lockIfConcurrent(Shard.Lock);
+  std::unique_ptr<ConstantFP> &Slot = Shard.Map[V];
 
   if (!Slot) {
     Type *Ty;
@@ -346,6 +346,48 @@ std::string DiagnosticInfoOptimizationBase::getMsg() const {
   return OS.str();
 }
 
+remarks::Remark DiagnosticInfoOptimizationBase::toRemark() const {
+  remarks::Remark R;
+  if (isPassed())
+    R.RemarkType = remarks::Type::Passed;
+  else if (isMissed())
+    R.RemarkType = remarks::Type::Missed;
+  else if (isAnalysis())
+    R.RemarkType = remarks::Type::Analysis;
+  else if (getKind() == DK_OptimizationRemarkAnalysisFPCommute)
+    R.RemarkType = remarks::Type::AnalysisFPCommute;
+  else if (getKind() == DK_OptimizationRemarkAnalysisAliasing)
+    R.RemarkType = remarks::Type::AnalysisAliasing;
+  else if (getKind() == DK_OptimizationFailure)
+    R.RemarkType = remarks::Type::Failure;
+  else
+    llvm_unreachable("Unknown remark type");
+
+  auto GetLocation = [](const DiagnosticLocation &DL) {
+    remarks::RemarkLocation Loc;
+    Loc.SourceFilePath = DL.getFilename();
+    Loc.SourceLine = DL.getLine();
+    Loc.SourceColumn = DL.getColumn();
+    return Loc;
+  };
+
+  R.PassName = PassName;
+  R.RemarkName = RemarkName;
+  R.FunctionName = GlobalValue::dropLLVMManglingEscape(getFunction().getName());
+  if (getLocation().isValid())
+    R.Loc = GetLocation(getLocation());
+  R.Hotness = Hotness;
+  for (const Argument &Arg : Args) {
+    remarks::Argument RArg;
+    RArg.Key = Arg.Key;
+    RArg.Val = Arg.Val;
+    if (Arg.Loc.isValid())
+      RArg.Loc = GetLocation(Arg.Loc);
+    R.Args.push_back(RArg);
+  }
+  return R;
+}
+
 namespace llvm {
 namespace yaml {
 
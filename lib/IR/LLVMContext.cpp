@@ -167,6 +167,19 @@ void LLVMContext::setDiagnosticsOutputFile(std::unique_ptr<yaml::Output> F) {
   pImpl->DiagnosticsOutputFile = std::move(F);
 }
 
+remarks::BinaryRemarkWriter *LLVMContext::getDiagnosticsBinaryOutput() {
+  return pImpl->DiagnosticsBinaryOutput.get();
+}
+
+void LLVMContext::setDiagnosticsBinaryOutput(
+    std::unique_ptr<remarks::BinaryRemarkWriter> W) {
+  pImpl->DiagnosticsBinaryOutput = std::move(W);
+}
+
+bool LLVMContext::hasDiagnosticsOutput() {
+  return pImpl->DiagnosticsOutputFile || pImpl->DiagnosticsBinaryOutput;
+}
+
 DiagnosticHandler::DiagnosticHandlerTy
 LLVMContext::getDiagnosticHandlerCallBack() const {
   return pImpl->DiagHandler->DiagHandlerCallback;
@@ -234,6 +247,8 @@ void LLVMContext::diagnose(const DiagnosticInfo &DI) {
       auto *P = const_cast<DiagnosticInfoOptimizationBase *>(OptDiagBase);
       *Out << P;
     }
+    if (remarks::BinaryRemarkWriter *W = getDiagnosticsBinaryOutput())
+      W->emit(OptDiagBase->toRemark());
   }
   // If there is a report handler, use it.
   if (pImpl->DiagHandler &&
@@ -328,6 +343,18 @@ void LLVMContext::enableDebugTypeODRUniquing() {
 
 void LLVMContext::disableDebugTypeODRUniquing() { pImpl->DITypeMap.reset(); }
 
+bool LLVMContext::isConcurrentUniquing() const {
+  return pImpl->ConcurrentUniquing;
+}
+
+void LLVMContext::enableConcurrentUniquing() {
+  pImpl->ConcurrentUniquing = true;
+}
+
+void LLVMContext::disableConcurrentUniquing() {
+  pImpl->ConcurrentUniquing = false;
+}
+
 void LLVMContext::setDiscardValueNames(bool Discard) {
   pImpl->DiscardValueNames = Discard;
 }
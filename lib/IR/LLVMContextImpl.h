@@ -39,14 +39,17 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Metadata.h"
 #include "llvm/IR/TrackingMDRef.h"
+#include "llvm/Remarks/BinaryRemarkWriter.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/YAMLTraits.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -1208,6 +1211,36 @@ public:
   void getAll(SmallVectorImpl<std::pair<unsigned, MDNode *>> &Result) const;
 };
 
+/// A uniquing table split into independently locked shards, so that threads
+/// creating unrelated entries don't contend on a single lock. Each shard is
+/// picked from the key's hash, mixed so that it doesn't correlate with the
+/// bucket the shard's own map puts the key in. The locks are only taken once
+/// the owning context is in concurrent uniquing mode.
+template <typename MapTy, unsigned NumShards = 32> class ShardedUniquingTable {
+  static_assert(isPowerOf2_32(NumShards), "NumShards must be a power of 2");
+
+public:
+  struct Shard {
+    std::mutex Lock;
+    MapTy Map;
+  };
+
+  Shard &getShard(unsigned Hash) {
+    return Shards[(Hash * 0x9E3779B9u) >> (32 - Log2_32(NumShards))];
+  }
+
+  Shard *begin() { return Shards; }
+  Shard *end() { return Shards + NumShards; }
+
+  void clear() {
+    for (Shard &S : Shards)
+      S.Map.clear();
+  }
+
+private:
+  Shard Shards[NumShards];
+};
+
 class LLVMContextImpl {
 public:
   /// OwnedModules - The set of modules instantiated in this context, and which
@@ -1222,28 +1255,56 @@ public:
   bool DiagnosticsHotnessRequested = false;
   uint64_t DiagnosticsHotnessThreshold = 0;
   std::unique_ptr<yaml::Output> DiagnosticsOutputFile;
+  std::unique_ptr<remarks::BinaryRemarkWriter> DiagnosticsBinaryOutput;
 
   LLVMContext::YieldCallbackTy YieldCallback = nullptr;
   void *YieldOpaqueHandle = nullptr;
 
+  /// Whether the uniquing tables below may be used from several threads at
+  /// once. See LLVMContext::enableConcurrentUniquing().
+  bool ConcurrentUniquing = false;
+
+  /// Lock \p M if the context is in concurrent uniquing mode.
+  template <typename MutexTy>
+  std::unique_lock<MutexTy> lockIfConcurrent(MutexTy &M) {
+    if (!ConcurrentUniquing)
+      return std::unique_lock<MutexTy>();
+    return std::unique_lock<MutexTy>(M);
+  }
+
+  /// Lock the uniqued MDNode sets for the creation of a node.
+  std::unique_lock<std::recursive_mutex> lockMetadata() {
+    return lockIfConcurrent(MetadataLock);
+  }
+
+  /// Lock the type tables and the TypeAllocator.
+  std::unique_lock<std::recursive_mutex> lockTypes() {
+    return lockIfConcurrent(TypeLock);
+  }
+
   using IntMapTy =
       DenseMap<APInt, std::unique_ptr<ConstantInt>, DenseMapAPIntKeyInfo>;
-  IntMapTy IntConstants;
+  ShardedUniquingTable<IntMapTy> IntConstants;
 
   using FPMapTy =
       DenseMap<APFloat, std::unique_ptr<ConstantFP>, DenseMapAPFloatKeyInfo>;
-  FPMapTy FPConstants;
+  ShardedUniquingTable<FPMapTy> FPConstants;
 
   FoldingSet<AttributeImpl> AttrsSet;
   FoldingSet<AttributeListImpl> AttrsLists;
   FoldingSet<AttributeSetNode> AttrsSetNodes;
 
-  StringMap<MDString, BumpPtrAllocator> MDStringCache;
+  using MDStringMapTy = StringMap<MDString, BumpPtrAllocator>;
+  ShardedUniquingTable<MDStringMapTy> MDStringCache;
   DenseMap<Value *, ValueAsMetadata *> ValuesAsMetadata;
   DenseMap<Metadata *, MetadataAsValue *> MetadataAsValues;
 
   DenseMap<const Value*, ValueName*> ValueNames;
 
+  /// Guards the uniqued MDNode sets and DistinctMDNodes in concurrent
+  /// uniquing mode. Recursive, as creating a node may create other nodes.
+  std::recursive_mutex MetadataLock;
+
 #define HANDLE_MDNODE_LEAF_UNIQUABLE(CLASS)                                    \
   DenseSet<CLASS *, CLASS##Info> CLASS##s;
 #include "llvm/IR/Metadata.def"
@@ -1290,6 +1351,12 @@ public:
   Type X86_FP80Ty, FP128Ty, PPC_FP128Ty, X86_MMXTy;
   IntegerType Int1Ty, Int8Ty, Int16Ty, Int32Ty, Int64Ty, Int128Ty;
   
+  /// Guards TypeAllocator and the type tables below in concurrent uniquing
+  /// mode. Types are few and are mostly created early, so unlike the constant
+  /// tables they share a single lock. Recursive, as creating a literal struct
+  /// sets its body.
+  std::recursive_mutex TypeLock;
+
   /// TypeAllocator - All dynamically allocated types are allocated from this.
   /// They live forever until the context is torn down.
   BumpPtrAllocator TypeAllocator;
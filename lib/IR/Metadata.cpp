@@ -350,6 +350,7 @@ ValueAsMetadata *ValueAsMetadata::get(Value *V) {
   assert(V && "Unexpected null Value");
 
   auto &Context = V->getContext();
+  auto MetadataLock = Context.pImpl->lockMetadata();
   auto *&Entry = Context.pImpl->ValuesAsMetadata[V];
   if (!Entry) {
     assert((isa<Constant>(V) || isa<Argument>(V) || isa<Instruction>(V)) &&
@@ -367,6 +368,7 @@ ValueAsMetadata *ValueAsMetadata::get(Value *V) {
 
 ValueAsMetadata *ValueAsMetadata::getIfExists(Value *V) {
   assert(V && "Unexpected null Value");
+  auto MetadataLock = V->getContext().pImpl->lockMetadata();
   return V->getContext().pImpl->ValuesAsMetadata.lookup(V);
 }
 
@@ -452,8 +454,9 @@ void ValueAsMetadata::handleRAUW(Value *From, Value *To) {
 //
 
 MDString *MDString::get(LLVMContext &Context, StringRef Str) {
-  auto &Store = Context.pImpl->MDStringCache;
-  auto I = Store.try_emplace(Str);
+  auto &Shard = Context.pImpl->MDStringCache.getShard(hash_value(Str));
+  auto Lock = Context.pImpl->lockIfConcurrent(Shard.Lock);
+  auto I = Shard.Map.try_emplace(Str);
   auto &MapEntry = I.first->getValue();
   if (!I.second)
     return &MapEntry;
@@ -812,6 +815,7 @@ void MDNode::eraseFromStore() {
 
 MDTuple *MDTuple::getImpl(LLVMContext &Context, ArrayRef<Metadata *> MDs,
                           StorageType Storage, bool ShouldCreate) {
+  auto MetadataLock = Context.pImpl->lockMetadata();
   unsigned Hash = 0;
   if (Storage == Uniqued) {
     MDTupleInfo::KeyTy Key(MDs);
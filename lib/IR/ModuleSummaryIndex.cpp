@@ -60,6 +60,23 @@ void ModuleSummaryIndex::collectDefinedGVSummariesPerModule(
   }
 }
 
+void ModuleSummaryIndex::removeModule(
+    StringRef ModulePath, const GVSummaryMapTy &DefinedGVSummaries) {
+  for (auto &GlobalList : DefinedGVSummaries) {
+    auto I = GlobalValueMap.find(GlobalList.first);
+    if (I == GlobalValueMap.end())
+      continue;
+    auto &SummaryList = I->second.SummaryList;
+    SummaryList.erase(
+        llvm::remove_if(SummaryList,
+                        [&](const std::unique_ptr<GlobalValueSummary> &S) {
+                          return S->modulePath() == ModulePath;
+                        }),
+        SummaryList.end());
+  }
+  ModulePathStringTable.erase(ModulePath);
+}
+
 GlobalValueSummary *
 ModuleSummaryIndex::getGlobalValueSummary(uint64_t ValueGUID,
                                           bool PerModuleIndex) const {
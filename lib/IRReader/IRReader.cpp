@@ -54,8 +54,18 @@ std::unique_ptr<Module> llvm::getLazyIRFileModule(StringRef Filename,
                                                   SMDiagnostic &Err,
                                                   LLVMContext &Context,
                                                   bool ShouldLazyLoadMetadata) {
+  // The bitcode reader doesn't need a null terminator, and not asking for one
+  // lets the file be mapped rather than read whatever its size: the lazy
+  // reader then only pages in the blocks it decodes.
   ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
-      MemoryBuffer::getFileOrSTDIN(Filename);
+      MemoryBuffer::getFileOrSTDIN(Filename, /*FileSize=*/-1,
+                                   /*RequiresNullTerminator=*/false);
+  // The assembly parser does need one. Standard input is always copied into a
+  // null-terminated buffer, other files are opened again.
+  if (FileOrErr && Filename != "-" &&
+      !isBitcode((const unsigned char *)(*FileOrErr)->getBufferStart(),
+                 (const unsigned char *)(*FileOrErr)->getBufferEnd()))
+    FileOrErr = MemoryBuffer::getFile(Filename);
   if (std::error_code EC = FileOrErr.getError()) {
     Err = SMDiagnostic(Filename, SourceMgr::DK_Error,
                        "Could not open input file: " + EC.message());
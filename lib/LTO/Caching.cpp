@@ -13,6 +13,7 @@
 
 #include "llvm/LTO/Caching.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CacheIndex.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -22,27 +23,34 @@
 using namespace llvm;
 using namespace llvm::lto;
 
-Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
-                                            AddBufferFn AddBuffer) {
-  if (std::error_code EC = sys::fs::create_directories(CacheDirectoryPath))
-    return errorCodeToError(EC);
-
+/// Create a cache in \p CacheDirectoryPath. If \p Index is not null, it is
+/// consulted before opening an entry, told about every new entry, and pruned
+/// according to \p Policy after each one.
+static NativeObjectCache createCache(StringRef CacheDirectoryPath,
+                                     AddBufferFn AddBuffer,
+                                     std::shared_ptr<CacheIndex> Index,
+                                     CachePruningPolicy Policy) {
   return [=](unsigned Task, StringRef Key) -> AddStreamFn {
     // This choice of file name allows the cache to be pruned (see pruneCache()
     // in include/llvm/Support/CachePruning.h).
     SmallString<64> EntryPath;
     sys::path::append(EntryPath, CacheDirectoryPath, "llvmcache-" + Key);
-    // First, see if we have a cache hit.
-    ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
-        MemoryBuffer::getFile(EntryPath);
-    if (MBOrErr) {
-      AddBuffer(Task, std::move(*MBOrErr));
-      return AddStreamFn();
-    }
+    // First, see if we have a cache hit. With an index, a miss doesn't need to
+    // touch the file system.
+    if (!Index || Index->lookup(Key)) {
+      ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+          MemoryBuffer::getFile(EntryPath);
+      if (MBOrErr) {
+        AddBuffer(Task, std::move(*MBOrErr));
+        return AddStreamFn();
+      }
 
-    if (MBOrErr.getError() != errc::no_such_file_or_directory)
-      report_fatal_error(Twine("Failed to open cache file ") + EntryPath +
-                         ": " + MBOrErr.getError().message() + "\n");
+      // The entry may have been pruned by another process since it was
+      // indexed, in which case it is simply rebuilt.
+      if (MBOrErr.getError() != errc::no_such_file_or_directory)
+        report_fatal_error(Twine("Failed to open cache file ") + EntryPath +
+                           ": " + MBOrErr.getError().message() + "\n");
+    }
 
     // This native object stream is responsible for commiting the resulting
     // file to the cache and calling AddBuffer to add it to the link.
@@ -51,13 +59,18 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
       sys::fs::TempFile TempFile;
       std::string EntryPath;
       unsigned Task;
+      std::shared_ptr<CacheIndex> Index;
+      CachePruningPolicy Policy;
+      std::string Key;
 
       CacheStream(std::unique_ptr<raw_pwrite_stream> OS, AddBufferFn AddBuffer,
                   sys::fs::TempFile TempFile, std::string EntryPath,
-                  unsigned Task)
+                  unsigned Task, std::shared_ptr<CacheIndex> Index,
+                  CachePruningPolicy Policy, std::string Key)
           : NativeObjectStream(std::move(OS)), AddBuffer(std::move(AddBuffer)),
             TempFile(std::move(TempFile)), EntryPath(std::move(EntryPath)),
-            Task(Task) {}
+            Task(Task), Index(std::move(Index)), Policy(std::move(Policy)),
+            Key(std::move(Key)) {}
 
       ~CacheStream() {
         // Make sure the stream is closed before committing it.
@@ -103,6 +116,12 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
                              TempFile.TmpName + " to " + EntryPath + ": " +
                              toString(std::move(E)) + "\n");
 
+        // The buffer is already open, so pruning can't take it away from us.
+        if (Index) {
+          Index->insert(Key, (*MBOrErr)->getBufferSize());
+          Index->prune(Policy);
+        }
+
         AddBuffer(Task, std::move(*MBOrErr));
       }
     };
@@ -121,7 +140,27 @@ Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
       // This CacheStream will move the temporary file into the cache when done.
       return llvm::make_unique<CacheStream>(
           llvm::make_unique<raw_fd_ostream>(Temp->FD, /* ShouldClose */ false),
-          AddBuffer, std::move(*Temp), EntryPath.str(), Task);
+          AddBuffer, std::move(*Temp), EntryPath.str(), Task, Index, Policy,
+          Key);
     };
   };
 }
+
+Expected<NativeObjectCache> lto::localCache(StringRef CacheDirectoryPath,
+                                            AddBufferFn AddBuffer) {
+  if (std::error_code EC = sys::fs::create_directories(CacheDirectoryPath))
+    return errorCodeToError(EC);
+  return createCache(CacheDirectoryPath, std::move(AddBuffer), nullptr,
+                     CachePruningPolicy());
+}
+
+Expected<NativeObjectCache> lto::indexedCache(StringRef CacheDirectoryPath,
+                                              AddBufferFn AddBuffer,
+                                              CachePruningPolicy Policy) {
+  Expected<std::unique_ptr<CacheIndex>> IndexOrErr =
+      CacheIndex::open(CacheDirectoryPath);
+  if (!IndexOrErr)
+    return IndexOrErr.takeError();
+  return createCache(CacheDirectoryPath, std::move(AddBuffer),
+                     std::move(*IndexOrErr), std::move(Policy));
+}
@@ -27,7 +27,9 @@
 #include "llvm/LTO/LTOBackend.h"
 #include "llvm/Linker/IRMover.h"
 #include "llvm/Object/IRObjectFile.h"
+#include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
@@ -52,6 +54,12 @@ using namespace object;
 
 #define DEBUG_TYPE "lto"
 
+STATISTIC(NumSummariesRead, "Number of ThinLTO module summaries read");
+STATISTIC(NumSummariesReused,
+          "Number of ThinLTO module summaries reused from the previous link");
+STATISTIC(NumSummariesDropped,
+          "Number of ThinLTO module summaries dropped from the previous link");
+
 static cl::opt<bool>
     DumpThinCGSCCs("dump-thin-cg-sccs", cl::init(false), cl::Hidden,
                    cl::desc("Dump the SCCs in the ThinLTO index's callgraph"));
@@ -495,6 +503,10 @@ Error LTO::add(std::unique_ptr<InputFile> Input,
   if (Conf.ResolutionFile)
     writeToResolutionFile(*Conf.ResolutionFile, Input.get(), Res);
 
+  if (!Conf.IncrementalIndexPath.empty() && !ThinLTO.LoadedIncrementalIndex)
+    if (Error Err = loadIncrementalIndex())
+      return Err;
+
   if (RegularLTO.CombinedModule->getTargetTriple().empty())
     RegularLTO.CombinedModule->setTargetTriple(Input->getTargetTriple());
 
@@ -715,10 +727,35 @@ Error LTO::linkRegularLTO(RegularLTOState::AddedModule Mod,
 Error LTO::addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
                       const SymbolResolution *&ResI,
                       const SymbolResolution *ResE) {
-  if (Error Err =
-          BM.readSummary(ThinLTO.CombinedIndex, BM.getModuleIdentifier(),
-                         ThinLTO.ModuleMap.size()))
-    return Err;
+  // An unchanged module of an incremental link keeps the summaries it had in
+  // the previous link's index; a changed one gets them replaced.
+  bool ReuseSummary = false;
+  auto Prev = ThinLTO.PrevModuleSummaries.find(BM.getModuleIdentifier());
+  if (Prev != ThinLTO.PrevModuleSummaries.end()) {
+    Expected<ModuleHash> HashOrErr = BM.getModuleHash();
+    if (!HashOrErr)
+      return HashOrErr.takeError();
+    auto &ModuleInfo = ThinLTO.CombinedIndex.modulePaths()[Prev->first()];
+    if (ModuleInfo.second == *HashOrErr &&
+        !all_of(*HashOrErr, [](uint32_t V) { return V == 0; })) {
+      ModuleInfo.first = ThinLTO.ModuleMap.size();
+      ReuseSummary = true;
+      ++NumSummariesReused;
+    } else {
+      ThinLTO.CombinedIndex.removeModule(Prev->first(), Prev->second);
+      ThinLTO.IncrementalIndexChanged = true;
+    }
+    ThinLTO.PrevModuleSummaries.erase(Prev);
+  }
+
+  if (!ReuseSummary) {
+    if (Error Err =
+            BM.readSummary(ThinLTO.CombinedIndex, BM.getModuleIdentifier(),
+                           ThinLTO.ModuleMap.size()))
+      return Err;
+    ThinLTO.IncrementalIndexChanged = true;
+    ++NumSummariesRead;
+  }
 
   for (const InputFile::Symbol &Sym : Syms) {
     assert(ResI != ResE);
@@ -737,7 +774,7 @@ Error LTO::addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
         if (Res.LinkerRedefined)
           if (auto S = ThinLTO.CombinedIndex.findSummaryInModule(
                   GUID, BM.getModuleIdentifier()))
-            S->setLinkage(GlobalValue::WeakAnyLinkage);
+            ThinLTO.LinkerRedefinedSummaries.push_back(S);
       }
 
       // If the linker resolved the symbol to a local definition then mark it
@@ -745,7 +782,7 @@ Error LTO::addThinLTO(BitcodeModule BM, ArrayRef<InputFile::Symbol> Syms,
       if (Res.FinalDefinitionInLinkageUnit) {
         if (auto S = ThinLTO.CombinedIndex.findSummaryInModule(
                 GUID, BM.getModuleIdentifier())) {
-          S->setDSOLocal(true);
+          ThinLTO.DSOLocalSummaries.push_back(S);
         }
       }
     }
@@ -764,7 +801,91 @@ unsigned LTO::getMaxTasks() const {
   return RegularLTO.ParallelCodeGenParallelismLevel + ThinLTO.ModuleMap.size();
 }
 
+Error LTO::loadIncrementalIndex() {
+  ThinLTO.LoadedIncrementalIndex = true;
+  ThinLTO.IncrementalIndexChanged = true;
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(Conf.IncrementalIndexPath, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!MBOrErr) {
+    // The first incremental link starts from scratch.
+    if (MBOrErr.getError() == errc::no_such_file_or_directory)
+      return Error::success();
+    return errorCodeToError(MBOrErr.getError());
+  }
+
+  Expected<std::vector<BitcodeModule>> BMsOrErr =
+      getBitcodeModuleList(**MBOrErr);
+  if (!BMsOrErr)
+    return BMsOrErr.takeError();
+  if (BMsOrErr->size() != 1)
+    return make_error<StringError>("Expected a single combined index in " +
+                                       Conf.IncrementalIndexPath,
+                                   inconvertibleErrorCode());
+  // The module path and ID only apply to per-module summaries.
+  if (Error Err = (*BMsOrErr)[0].readSummary(ThinLTO.CombinedIndex, "", 0))
+    return Err;
+
+  ThinLTO.CombinedIndex.collectDefinedGVSummariesPerModule(
+      ThinLTO.PrevModuleSummaries);
+  for (auto &Mod : ThinLTO.CombinedIndex.modulePaths())
+    ThinLTO.PrevModuleSummaries.try_emplace(Mod.first());
+  ThinLTO.IncrementalIndexChanged = false;
+  return Error::success();
+}
+
+Error LTO::saveIncrementalIndex() {
+  // Drop the modules that are no longer part of the link.
+  for (auto &Prev : ThinLTO.PrevModuleSummaries) {
+    ThinLTO.CombinedIndex.removeModule(Prev.first(), Prev.second);
+    ThinLTO.IncrementalIndexChanged = true;
+    ++NumSummariesDropped;
+  }
+  ThinLTO.PrevModuleSummaries.clear();
+  if (!ThinLTO.IncrementalIndexChanged)
+    return Error::success();
+
+  // Only save the ThinLTO modules: summaries of regular LTO modules are read
+  // again by every link.
+  StringMap<GVSummaryMapTy> ModuleToDefinedGVSummaries;
+  ThinLTO.CombinedIndex.collectDefinedGVSummariesPerModule(
+      ModuleToDefinedGVSummaries);
+  std::map<std::string, GVSummaryMapTy> ModuleToSummariesForIndex;
+  for (auto &Mod : ThinLTO.ModuleMap)
+    if (ThinLTO.CombinedIndex.modulePaths().count(Mod.first))
+      ModuleToSummariesForIndex[Mod.first] =
+          std::move(ModuleToDefinedGVSummaries[Mod.first]);
+
+  // Write to a temporary file and rename it, so that a link that is
+  // interrupted doesn't leave a truncated index behind.
+  SmallString<128> TempPath;
+  int FD;
+  if (std::error_code EC = sys::fs::createUniqueFile(
+          Conf.IncrementalIndexPath + "-%%%%%%.tmp", FD, TempPath))
+    return errorCodeToError(EC);
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    WriteIndexToFile(ThinLTO.CombinedIndex, OS, &ModuleToSummariesForIndex);
+  }
+  if (std::error_code EC =
+          sys::fs::rename(TempPath, Conf.IncrementalIndexPath)) {
+    sys::fs::remove(TempPath);
+    return errorCodeToError(EC);
+  }
+  return Error::success();
+}
+
 Error LTO::run(AddStreamFn AddStream, NativeObjectCache Cache) {
+  if (!Conf.IncrementalIndexPath.empty())
+    if (Error Err = saveIncrementalIndex())
+      return Err;
+
+  // Now that the index is saved, apply the symbol resolutions to it.
+  for (GlobalValueSummary *S : ThinLTO.LinkerRedefinedSummaries)
+    S->setLinkage(GlobalValue::WeakAnyLinkage);
+  for (GlobalValueSummary *S : ThinLTO.DSOLocalSummaries)
+    S->setDSOLocal(true);
+
   // Compute "dead" symbols, we don't want to import/export these!
   DenseSet<GlobalValue::GUID> GUIDPreservedSymbols;
   DenseMap<GlobalValue::GUID, PrevailingType> GUIDPrevailingResolutions;
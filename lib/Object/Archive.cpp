@@ -19,13 +19,17 @@
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/Error.h"
 #include "llvm/Support/Chrono.h"
+#include "llvm/Support/DJB.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -541,6 +545,39 @@ void Archive::setFirstRegular(const Child &C) {
   FirstRegularStartOfFile = C.StartOfFile;
 }
 
+const char Archive::SymbolIndexName[] = "__.SYMIDX";
+
+bool Archive::readSymbolIndex(const Child &C) {
+  Expected<StringRef> NameOrErr = C.getRawName();
+  if (!NameOrErr) {
+    consumeError(NameOrErr.takeError());
+    return false;
+  }
+  StringRef Name = NameOrErr.get();
+  if (Name.startswith("#1/")) {
+    NameOrErr = C.getName();
+    if (!NameOrErr) {
+      consumeError(NameOrErr.takeError());
+      return false;
+    }
+    Name = NameOrErr.get();
+  } else if (Name.endswith("/")) {
+    Name = Name.drop_back();
+  }
+  if (Name != SymbolIndexName)
+    return false;
+
+  // The symbol index is never an external member, but we still must check any
+  // Expected<> return value.
+  Expected<StringRef> BufOrErr = C.getBuffer();
+  if (!BufOrErr) {
+    consumeError(BufOrErr.takeError());
+    return false;
+  }
+  SymbolIndexMember = BufOrErr.get();
+  return true;
+}
+
 Archive::Archive(MemoryBufferRef Source, Error &Err)
     : Binary(Binary::ID_Archive, Source) {
   ErrorAsOutParameter ErrAsOutParam(&Err);
@@ -625,6 +662,8 @@ Archive::Archive(MemoryBufferRef Source, Error &Err)
     SymbolTable = BufOrErr.get();
     if (Increment())
       return;
+    if (I != E && readSymbolIndex(*C) && Increment())
+      return;
     setFirstRegular(*C);
 
     Err = Error::success();
@@ -651,6 +690,8 @@ Archive::Archive(MemoryBufferRef Source, Error &Err)
       SymbolTable = BufOrErr.get();
       if (Increment())
         return;
+      if (I != E && readSymbolIndex(*C) && Increment())
+        return;
     }
     else if (Name == "__.SYMDEF_64 SORTED" || Name == "__.SYMDEF_64") {
       Format = K_DARWIN64;
@@ -664,6 +705,8 @@ Archive::Archive(MemoryBufferRef Source, Error &Err)
       SymbolTable = BufOrErr.get();
       if (Increment())
         return;
+      if (I != E && readSymbolIndex(*C) && Increment())
+        return;
     }
     setFirstRegular(*C);
     return;
@@ -689,6 +732,8 @@ Archive::Archive(MemoryBufferRef Source, Error &Err)
 
     if (Increment())
       return;
+    if (I != E && readSymbolIndex(*C) && Increment())
+      return;
     if (I == E) {
       Err = Error::success();
       return;
@@ -976,19 +1021,131 @@ uint32_t Archive::getNumberOfSymbols() const {
 }
 
 Expected<Optional<Archive::Child>> Archive::findSym(StringRef name) const {
-  Archive::symbol_iterator bs = symbol_begin();
-  Archive::symbol_iterator es = symbol_end();
-
-  for (; bs != es; ++bs) {
-    StringRef SymName = bs->getName();
-    if (SymName == name) {
-      if (auto MemberOrErr = bs->getMember())
-        return Child(*MemberOrErr);
-      else
-        return MemberOrErr.takeError();
+  Optional<Symbol> Sym = findSymbol(name);
+  if (!Sym)
+    return Optional<Child>();
+  if (auto MemberOrErr = Sym->getMember())
+    return Child(*MemberOrErr);
+  else
+    return MemberOrErr.takeError();
+}
+
+// The symbol index is a hash table with open addressing over the symbol
+// table. All the fields are little endian:
+//
+//   char     Magic[8]
+//   uint64_t SymbolTableHash   xxHash64 of the symbol table contents
+//   uint32_t NumSymbols
+//   uint32_t NumBuckets        a power of two, at least twice NumSymbols
+//   Bucket   Buckets[NumBuckets]
+//
+// where each bucket is a uint32_t triple: the djbHash of the name, the index
+// of the symbol (or EmptyBucket), and the offset of the name in the symbol
+// table. Only the first symbol with a given name is in the table.
+static const char SymbolIndexMagic[] = "!<symidx";
+static const uint32_t SymbolIndexHeaderSize = 24;
+static const uint32_t SymbolIndexBucketSize = 12;
+static const uint32_t EmptyBucket = ~0U;
+
+static uint32_t getSymbolIndexBuckets(uint32_t NumSymbols) {
+  return PowerOf2Ceil(std::max<uint64_t>(2 * uint64_t(NumSymbols), 2));
+}
+
+uint64_t Archive::getSymbolIndexSize(uint32_t NumSymbols) {
+  return SymbolIndexHeaderSize +
+         uint64_t(getSymbolIndexBuckets(NumSymbols)) * SymbolIndexBucketSize;
+}
+
+std::string
+Archive::buildSymbolIndex(StringRef SymbolTable,
+                          ArrayRef<std::pair<StringRef, uint32_t>> Symbols) {
+  uint32_t NumBuckets = getSymbolIndexBuckets(Symbols.size());
+  std::vector<uint32_t> Hashes(NumBuckets);
+  std::vector<uint32_t> Indices(NumBuckets, EmptyBucket);
+  for (uint32_t I = 0, E = Symbols.size(); I != E; ++I) {
+    StringRef Name = Symbols[I].first;
+    uint32_t Hash = djbHash(Name);
+    uint32_t Bucket = Hash & (NumBuckets - 1);
+    while (Indices[Bucket] != EmptyBucket &&
+           (Hashes[Bucket] != Hash || Symbols[Indices[Bucket]].first != Name))
+      Bucket = (Bucket + 1) & (NumBuckets - 1);
+    // Keep the first symbol with this name.
+    if (Indices[Bucket] != EmptyBucket)
+      continue;
+    Hashes[Bucket] = Hash;
+    Indices[Bucket] = I;
+  }
+
+  std::string Index;
+  raw_string_ostream OS(Index);
+  OS << StringRef(SymbolIndexMagic, 8);
+  Writer W(OS, support::little);
+  W.write(xxHash64(SymbolTable));
+  W.write(uint32_t(Symbols.size()));
+  W.write(NumBuckets);
+  for (uint32_t B = 0; B != NumBuckets; ++B) {
+    W.write(Hashes[B]);
+    W.write(Indices[B]);
+    W.write(Indices[B] == EmptyBucket ? 0 : Symbols[Indices[B]].second);
+  }
+  OS.flush();
+  return Index;
+}
+
+void Archive::initSymbolIndex() const {
+  uint32_t NumSymbols = getNumberOfSymbols();
+
+  // Use the index member if it matches the symbol table.
+  StringRef Member = SymbolIndexMember;
+  if (Member.size() >= SymbolIndexHeaderSize &&
+      Member.startswith(StringRef(SymbolIndexMagic, 8)) &&
+      read64le(Member.data() + 8) == xxHash64(SymbolTable) &&
+      read32le(Member.data() + 16) == NumSymbols) {
+    uint32_t NumBuckets = read32le(Member.data() + 20);
+    if (isPowerOf2_32(NumBuckets) &&
+        Member.size() >= SymbolIndexHeaderSize +
+                             uint64_t(NumBuckets) * SymbolIndexBucketSize) {
+      SymbolIndex = Member;
+      return;
     }
   }
-  return Optional<Child>();
+
+  std::vector<std::pair<StringRef, uint32_t>> Symbols;
+  Symbols.reserve(NumSymbols);
+  for (const Symbol &S : symbols())
+    Symbols.emplace_back(S.getName(), S.StringIndex);
+  OwnedSymbolIndex = buildSymbolIndex(SymbolTable, Symbols);
+  SymbolIndex = OwnedSymbolIndex;
+}
+
+Optional<Archive::Symbol> Archive::findSymbol(StringRef Name) const {
+  if (!hasSymbolTable())
+    return None;
+  llvm::call_once(SymbolIndexFlag, [this]() { initSymbolIndex(); });
+
+  uint32_t NumSymbols = read32le(SymbolIndex.data() + 16);
+  uint32_t NumBuckets = read32le(SymbolIndex.data() + 20);
+  const char *Buckets = SymbolIndex.data() + SymbolIndexHeaderSize;
+  uint32_t Hash = djbHash(Name);
+  for (uint32_t I = 0, Bucket = Hash & (NumBuckets - 1); I != NumBuckets;
+       ++I, Bucket = (Bucket + 1) & (NumBuckets - 1)) {
+    const char *B = Buckets + Bucket * SymbolIndexBucketSize;
+    uint32_t Index = read32le(B + 4);
+    if (Index == EmptyBucket)
+      break;
+    if (read32le(B) != Hash)
+      continue;
+    // The index may come from the archive, so check the entry before using
+    // it.
+    uint32_t StringIndex = read32le(B + 8);
+    if (Index >= NumSymbols || StringIndex >= SymbolTable.size())
+      break;
+    StringRef Tail = SymbolTable.drop_front(StringIndex);
+    if (Tail.startswith(Name) && Tail.size() > Name.size() &&
+        Tail[Name.size()] == '\0')
+      return Symbol(this, Index, StringIndex);
+  }
+  return None;
 }
 
 // Returns true if archive file contains no member file.
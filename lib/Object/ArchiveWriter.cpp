@@ -22,10 +22,13 @@
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cstring>
 
 #if !defined(_MSC_VER) && !defined(__MINGW32__)
 #include <unistd.h>
@@ -310,13 +313,15 @@ static void printNBits(raw_ostream &Out, object::Archive::Kind Kind,
 
 static void writeSymbolTable(raw_ostream &Out, object::Archive::Kind Kind,
                              bool Deterministic, ArrayRef<MemberData> Members,
-                             StringRef StringTable) {
+                             StringRef StringTable, bool WriteIndex) {
   if (StringTable.empty())
     return;
 
   unsigned NumSyms = 0;
   for (const MemberData &M : Members)
     NumSyms += M.Symbols.size();
+  if (NumSyms == 0)
+    WriteIndex = false;
 
   unsigned Size = 0;
   Size += is64BitKind(Kind) ? 8 : 4; // Number of entries
@@ -328,6 +333,7 @@ static void writeSymbolTable(raw_ostream &Out, object::Archive::Kind Kind,
     Size += NumSyms * 4; // Table
   if (isBSDLike(Kind))
     Size += 4; // byte count
+  unsigned StringTableStart = Size;
   Size += StringTable.size();
   // ld64 expects the members to be 8-byte aligned for 64-bit content and at
   // least 4-byte aligned for 32-bit content.  Opt for the larger encoding
@@ -347,36 +353,90 @@ static void writeSymbolTable(raw_ostream &Out, object::Archive::Kind Kind,
 
   uint64_t Pos = Out.tell() + Size;
 
+  // The symbol index member, if any, goes right after the symbol table.
+  std::string IndexHeader;
+  uint64_t IndexSize = 0;
+  if (WriteIndex) {
+    IndexSize = object::Archive::getSymbolIndexSize(NumSyms);
+    raw_string_ostream IndexOut(IndexHeader);
+    if (isBSDLike(Kind))
+      printBSDMemberHeader(IndexOut, Pos, object::Archive::SymbolIndexName,
+                           now(Deterministic), 0, 0, 0, IndexSize);
+    else
+      printGNUSmallMemberHeader(IndexOut, object::Archive::SymbolIndexName,
+                                now(Deterministic), 0, 0, 0, IndexSize);
+    IndexOut.flush();
+    Pos += IndexHeader.size() + IndexSize;
+  }
+
+  // The index is built from the contents of the table, so keep them.
+  SmallString<0> ContentsBuf;
+  raw_svector_ostream Contents(ContentsBuf);
+  std::vector<std::pair<StringRef, uint32_t>> Symbols;
+
   if (isBSDLike(Kind))
-    print<uint32_t>(Out, Kind, NumSyms * 8);
+    print<uint32_t>(Contents, Kind, NumSyms * 8);
   else
-    printNBits(Out, Kind, NumSyms);
+    printNBits(Contents, Kind, NumSyms);
 
   for (const MemberData &M : Members) {
     for (unsigned StringOffset : M.Symbols) {
       if (isBSDLike(Kind))
-        print<uint32_t>(Out, Kind, StringOffset);
-      printNBits(Out, Kind, Pos); // member offset
+        print<uint32_t>(Contents, Kind, StringOffset);
+      printNBits(Contents, Kind, Pos); // member offset
+      if (WriteIndex)
+        Symbols.emplace_back(StringTable.data() + StringOffset,
+                             StringTableStart + StringOffset);
     }
     Pos += M.Header.size() + M.Data.size() + M.Padding.size();
   }
 
   if (isBSDLike(Kind))
     // byte count of the string table
-    print<uint32_t>(Out, Kind, StringTable.size());
-  Out << StringTable;
+    print<uint32_t>(Contents, Kind, StringTable.size());
+  Contents << StringTable;
 
   while (Pad--)
-    Out.write(uint8_t(0));
+    Contents.write(uint8_t(0));
+  Out << ContentsBuf;
+
+  if (WriteIndex) {
+    std::string Index =
+        object::Archive::buildSymbolIndex(ContentsBuf, Symbols);
+    assert(Index.size() == IndexSize && "wrong symbol index size");
+    Out << IndexHeader << Index;
+  }
 }
 
-static Expected<std::vector<unsigned>>
-getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
-  std::vector<unsigned> Ret;
-  LLVMContext Context;
+namespace {
+/// The symbol table entries of one member, with offsets relative to the start
+/// of its own names.
+struct MemberSymbols {
+  std::vector<unsigned> Offsets;
+  std::string Names;
+  bool IsObject = false;
+  std::error_code EC;
+};
+} // namespace
+
+static MemberSymbols getSymbols(const NewArchiveMember &M) {
+  MemberSymbols Ret;
+  raw_string_ostream SymNames(Ret.Names);
 
+  if (M.Symbols) {
+    Ret.IsObject = !M.Symbols->empty();
+    for (StringRef Name : *M.Symbols) {
+      Ret.Offsets.push_back(SymNames.tell());
+      SymNames << Name << '\0';
+    }
+    SymNames.flush();
+    return Ret;
+  }
+
+  LLVMContext Context;
   Expected<std::unique_ptr<object::SymbolicFile>> ObjOrErr =
-      object::SymbolicFile::createSymbolicFile(Buf, llvm::file_magic::unknown,
+      object::SymbolicFile::createSymbolicFile(M.Buf->getMemBufferRef(),
+                                               llvm::file_magic::unknown,
                                                &Context);
   if (!ObjOrErr) {
     // FIXME: check only for "not an object file" errors.
@@ -384,32 +444,42 @@ getSymbols(MemoryBufferRef Buf, raw_ostream &SymNames, bool &HasObject) {
     return Ret;
   }
 
-  HasObject = true;
+  Ret.IsObject = true;
   object::SymbolicFile &Obj = *ObjOrErr.get();
   for (const object::BasicSymbolRef &S : Obj.symbols()) {
     if (!isArchiveSymbol(S))
       continue;
-    Ret.push_back(SymNames.tell());
-    if (auto EC = S.printName(SymNames))
-      return errorCodeToError(EC);
+    Ret.Offsets.push_back(SymNames.tell());
+    if ((Ret.EC = S.printName(SymNames)))
+      break;
     SymNames << '\0';
   }
+  SymNames.flush();
   return Ret;
 }
 
 static Expected<std::vector<MemberData>>
 computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                   object::Archive::Kind Kind, bool Thin, StringRef ArcName,
-                  ArrayRef<NewArchiveMember> NewMembers) {
+                  ArrayRef<NewArchiveMember> NewMembers, bool WriteSymtab) {
   static char PaddingData[8] = {'\n', '\n', '\n', '\n', '\n', '\n', '\n', '\n'};
 
+  // Reading the symbols of a member means parsing it, which is by far the
+  // most expensive part of writing an archive, so do it for all the members
+  // at once. The results are appended to SymNames in member order below.
+  std::vector<MemberSymbols> Symbols(WriteSymtab ? NewMembers.size() : 0);
+  parallel::for_each_n(parallel::par, size_t(0), Symbols.size(), [&](size_t I) {
+    Symbols[I] = getSymbols(NewMembers[I]);
+  });
+
   // This ignores the symbol table, but we only need the value mod 8 and the
   // symbol table is aligned to be a multiple of 8 bytes
   uint64_t Pos = 0;
 
   std::vector<MemberData> Ret;
   bool HasObject = false;
-  for (const NewArchiveMember &M : NewMembers) {
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -430,13 +500,23 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
                       Buf.getBufferSize() + MemberPadding);
     Out.flush();
 
-    Expected<std::vector<unsigned>> Symbols =
-        getSymbols(Buf, SymNames, HasObject);
-    if (auto E = Symbols.takeError())
-      return std::move(E);
+    std::vector<unsigned> MemberSymbolOffsets;
+    if (WriteSymtab) {
+      MemberSymbols &MS = Symbols[I];
+      if (MS.EC)
+        return errorCodeToError(MS.EC);
+      HasObject |= MS.IsObject;
+      uint64_t Base = SymNames.tell();
+      for (unsigned Offset : MS.Offsets)
+        MemberSymbolOffsets.push_back(Base + Offset);
+      SymNames << MS.Names;
+      // Release the names now, they can add up for large archives.
+      MS = MemberSymbols();
+    }
 
     Pos += Header.size() + Data.size() + Padding.size();
-    Ret.push_back({std::move(*Symbols), std::move(Header), Data, Padding});
+    Ret.push_back(
+        {std::move(MemberSymbolOffsets), std::move(Header), Data, Padding});
   }
   // If there are no symbols, emit an empty symbol table, to satisfy Solaris
   // tools, older versions of which expect a symbol table in a non-empty
@@ -450,7 +530,8 @@ Error llvm::writeArchive(StringRef ArcName,
                          ArrayRef<NewArchiveMember> NewMembers,
                          bool WriteSymtab, object::Archive::Kind Kind,
                          bool Deterministic, bool Thin,
-                         std::unique_ptr<MemoryBuffer> OldArchiveBuf) {
+                         std::unique_ptr<MemoryBuffer> OldArchiveBuf,
+                         bool WriteSymbolIndex) {
   assert((!Thin || !isBSDLike(Kind)) && "Only the gnu format has a thin mode");
 
   SmallString<0> SymNamesBuf;
@@ -458,8 +539,8 @@ Error llvm::writeArchive(StringRef ArcName,
   SmallString<0> StringTableBuf;
   raw_svector_ostream StringTable(StringTableBuf);
 
-  Expected<std::vector<MemberData>> DataOrErr =
-      computeMemberData(StringTable, SymNames, Kind, Thin, ArcName, NewMembers);
+  Expected<std::vector<MemberData>> DataOrErr = computeMemberData(
+      StringTable, SymNames, Kind, Thin, ArcName, NewMembers, WriteSymtab);
   if (Error E = DataOrErr.takeError())
     return E;
   std::vector<MemberData> &Data = *DataOrErr;
@@ -470,6 +551,13 @@ Error llvm::writeArchive(StringRef ArcName,
   // We would like to detect if we need to switch to a 64-bit symbol table.
   if (WriteSymtab) {
     uint64_t MaxOffset = 0;
+    if (WriteSymbolIndex) {
+      unsigned NumSyms = 0;
+      for (const MemberData &M : Data)
+        NumSyms += M.Symbols.size();
+      // The index member has a 60 byte header.
+      MaxOffset += 60 + object::Archive::getSymbolIndexSize(NumSyms);
+    }
     uint64_t LastOffset = MaxOffset;
     for (const auto& M : Data) {
       // Record the start of the member's offset
@@ -499,24 +587,41 @@ Error llvm::writeArchive(StringRef ArcName,
       Kind = object::Archive::K_GNU64;
   }
 
-  Expected<sys::fs::TempFile> Temp =
-      sys::fs::TempFile::create(ArcName + ".temp-archive-%%%%%%%.a");
-  if (!Temp)
-    return Temp.takeError();
-
-  raw_fd_ostream Out(Temp->FD, false);
+  // Only the magic and the symbol table are built in memory, the members are
+  // copied straight into the output file.
+  SmallString<0> HeadBuf;
+  raw_svector_ostream Head(HeadBuf);
   if (Thin)
-    Out << "!<thin>\n";
+    Head << "!<thin>\n";
   else
-    Out << "!<arch>\n";
+    Head << "!<arch>\n";
 
   if (WriteSymtab)
-    writeSymbolTable(Out, Kind, Deterministic, Data, SymNamesBuf);
+    writeSymbolTable(Head, Kind, Deterministic, Data, SymNamesBuf,
+                     WriteSymbolIndex);
 
+  uint64_t Size = HeadBuf.size();
   for (const MemberData &M : Data)
-    Out << M.Header << M.Data << M.Padding;
-
-  Out.flush();
+    Size += M.Header.size() + M.Data.size() + M.Padding.size();
+
+  Expected<std::unique_ptr<FileOutputBuffer>> OutOrErr =
+      FileOutputBuffer::create(ArcName, Size);
+  if (!OutOrErr)
+    return OutOrErr.takeError();
+  std::unique_ptr<FileOutputBuffer> Out = std::move(*OutOrErr);
+
+  uint8_t *Buf = Out->getBufferStart();
+  auto Append = [&Buf](StringRef S) {
+    if (!S.empty())
+      memcpy(Buf, S.data(), S.size());
+    Buf += S.size();
+  };
+  Append(HeadBuf);
+  for (const MemberData &M : Data) {
+    Append(M.Header);
+    Append(M.Data);
+    Append(M.Padding);
+  }
 
   // At this point, we no longer need whatever backing memory
   // was used to generate the NewMembers. On Windows, this buffer
@@ -530,5 +635,5 @@ Error llvm::writeArchive(StringRef ArcName,
   // closed before we attempt to rename.
   OldArchiveBuf.reset();
 
-  return Temp->keep(ArcName);
+  return Out->commit();
 }
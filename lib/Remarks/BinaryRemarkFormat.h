@@ -0,0 +1,53 @@
+//===- BinaryRemarkFormat.h - The binary remark format ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// A binary remark file is a header followed by remarks. All the numbers are
+// ULEB128-encoded.
+//
+//   Header:   the magic "RMRK", Version
+//   Remark:   Type, Flags, PassName, RemarkName, FunctionName,
+//             [Location]     if Flags has RF_HasLocation
+//             [Hotness]      if Flags has RF_HasHotness
+//             NumArgs, NumArgs * Argument
+//   Argument: Key, Val, HasLocation, [Location]
+//   Location: File, Line, Column
+//
+// A string is a number Ref. If its low bit is set, the string is defined in
+// place: its contents are the next Ref >> 1 bytes, and it is given the next
+// string number. Otherwise it is the string numbered Ref >> 1.
+//
+// A header may appear between two remarks, which happens when files are
+// concatenated. It starts a new file, whose strings are numbered from zero.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_REMARKS_BINARYREMARKFORMAT_H
+#define LLVM_LIB_REMARKS_BINARYREMARKFORMAT_H
+
+#include "llvm/ADT/StringRef.h"
+
+namespace llvm {
+namespace remarks {
+
+static const char BinaryRemarkMagic[] = {'R', 'M', 'R', 'K'};
+static const uint64_t BinaryRemarkVersion = 1;
+
+enum BinaryRemarkFlags : uint64_t {
+  RF_HasLocation = 1 << 0,
+  RF_HasHotness = 1 << 1,
+};
+
+inline StringRef getBinaryRemarkMagic() {
+  return StringRef(BinaryRemarkMagic, sizeof(BinaryRemarkMagic));
+}
+
+} // end namespace remarks
+} // end namespace llvm
+
+#endif // LLVM_LIB_REMARKS_BINARYREMARKFORMAT_H
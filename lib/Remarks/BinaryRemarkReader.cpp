@@ -0,0 +1,154 @@
+//===- BinaryRemarkReader.cpp - Read binary remarks -----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/BinaryRemarkReader.h"
+#include "BinaryRemarkFormat.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/LEB128.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+bool BinaryRemarkReader::isBinaryRemarks(StringRef Buf) {
+  return Buf.startswith(getBinaryRemarkMagic());
+}
+
+Expected<std::unique_ptr<BinaryRemarkReader>>
+BinaryRemarkReader::create(StringRef Buf) {
+  std::unique_ptr<BinaryRemarkReader> Reader(new BinaryRemarkReader(Buf));
+  if (Error E = Reader->readHeader())
+    return std::move(E);
+  return std::move(Reader);
+}
+
+Error BinaryRemarkReader::makeError(const Twine &Msg) const {
+  return make_error<StringError>("malformed remarks at offset " +
+                                     Twine(FieldOffset) + ": " + Msg,
+                                 inconvertibleErrorCode());
+}
+
+Error BinaryRemarkReader::readHeader() {
+  FieldOffset = Offset;
+  if (!Buf.substr(Offset).startswith(getBinaryRemarkMagic()))
+    return makeError("not a binary remark file");
+  Offset += getBinaryRemarkMagic().size();
+  uint64_t Version;
+  if (Error E = readNumber(Version))
+    return E;
+  if (Version != BinaryRemarkVersion)
+    return makeError("unsupported version " + Twine(Version));
+  Strings.clear();
+  return Error::success();
+}
+
+Error BinaryRemarkReader::readNumber(uint64_t &N) {
+  unsigned Size;
+  const char *Err;
+  FieldOffset = Offset;
+  N = decodeULEB128(Buf.bytes_begin() + Offset, &Size, Buf.bytes_end(), &Err);
+  if (Err)
+    return makeError(Err);
+  Offset += Size;
+  return Error::success();
+}
+
+Error BinaryRemarkReader::readString(StringRef &S) {
+  uint64_t Ref;
+  if (Error E = readNumber(Ref))
+    return E;
+  if (!(Ref & 1)) {
+    if ((Ref >> 1) >= Strings.size())
+      return makeError("invalid string number " + Twine(Ref >> 1));
+    S = Strings[Ref >> 1];
+    return Error::success();
+  }
+  uint64_t Size = Ref >> 1;
+  if (Size > Buf.size() - Offset)
+    return makeError("string extends past the end of the file");
+  S = Buf.substr(Offset, Size);
+  Offset += Size;
+  Strings.push_back(S);
+  return Error::success();
+}
+
+Error BinaryRemarkReader::readLocation(RemarkLocation &Loc) {
+  uint64_t Line, Column;
+  if (Error E = readString(Loc.SourceFilePath))
+    return E;
+  if (Error E = readNumber(Line))
+    return E;
+  if (Error E = readNumber(Column))
+    return E;
+  Loc.SourceLine = Line;
+  Loc.SourceColumn = Column;
+  return Error::success();
+}
+
+Expected<const Remark *> BinaryRemarkReader::next() {
+  if (isBinaryRemarks(Buf.substr(Offset)))
+    if (Error E = readHeader())
+      return std::move(E);
+  if (Offset == Buf.size())
+    return nullptr;
+
+  Remark &R = Current;
+  uint64_t RemarkType, Flags, NumArgs;
+  if (Error E = readNumber(RemarkType))
+    return std::move(E);
+  if (RemarkType > static_cast<uint64_t>(Type::Failure))
+    return makeError("invalid remark type " + Twine(RemarkType));
+  R.RemarkType = static_cast<Type>(RemarkType);
+  if (Error E = readNumber(Flags))
+    return std::move(E);
+  if (Error E = readString(R.PassName))
+    return std::move(E);
+  if (Error E = readString(R.RemarkName))
+    return std::move(E);
+  if (Error E = readString(R.FunctionName))
+    return std::move(E);
+
+  R.Loc.reset();
+  if (Flags & RF_HasLocation) {
+    RemarkLocation Loc;
+    if (Error E = readLocation(Loc))
+      return std::move(E);
+    R.Loc = Loc;
+  }
+  R.Hotness.reset();
+  if (Flags & RF_HasHotness) {
+    uint64_t Hotness;
+    if (Error E = readNumber(Hotness))
+      return std::move(E);
+    R.Hotness = Hotness;
+  }
+
+  if (Error E = readNumber(NumArgs))
+    return std::move(E);
+  // Every argument takes at least three bytes.
+  if (NumArgs > (Buf.size() - Offset) / 3)
+    return makeError("too many arguments");
+  R.Args.resize(NumArgs);
+  for (Argument &Arg : R.Args) {
+    uint64_t HasLocation;
+    if (Error E = readString(Arg.Key))
+      return std::move(E);
+    if (Error E = readString(Arg.Val))
+      return std::move(E);
+    if (Error E = readNumber(HasLocation))
+      return std::move(E);
+    Arg.Loc.reset();
+    if (HasLocation) {
+      RemarkLocation Loc;
+      if (Error E = readLocation(Loc))
+        return std::move(E);
+      Arg.Loc = Loc;
+    }
+  }
+  return &Current;
+}
@@ -0,0 +1,64 @@
+//===- BinaryRemarkWriter.cpp - Write binary remarks ----------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/BinaryRemarkWriter.h"
+#include "BinaryRemarkFormat.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+BinaryRemarkWriter::BinaryRemarkWriter(raw_ostream &OS) : OS(OS) {
+  OS << getBinaryRemarkMagic();
+  encodeULEB128(BinaryRemarkVersion, OS);
+}
+
+void BinaryRemarkWriter::emitString(StringRef S) {
+  auto Inserted = StringIDs.insert({S, StringIDs.size()});
+  if (!Inserted.second) {
+    encodeULEB128(uint64_t(Inserted.first->second) << 1, OS);
+    return;
+  }
+  encodeULEB128(uint64_t(S.size()) << 1 | 1, OS);
+  OS << S;
+}
+
+void BinaryRemarkWriter::emitLocation(const RemarkLocation &Loc) {
+  emitString(Loc.SourceFilePath);
+  encodeULEB128(Loc.SourceLine, OS);
+  encodeULEB128(Loc.SourceColumn, OS);
+}
+
+void BinaryRemarkWriter::emit(const Remark &R) {
+  uint64_t Flags = 0;
+  if (R.Loc)
+    Flags |= RF_HasLocation;
+  if (R.Hotness)
+    Flags |= RF_HasHotness;
+
+  encodeULEB128(static_cast<uint64_t>(R.RemarkType), OS);
+  encodeULEB128(Flags, OS);
+  emitString(R.PassName);
+  emitString(R.RemarkName);
+  emitString(R.FunctionName);
+  if (R.Loc)
+    emitLocation(*R.Loc);
+  if (R.Hotness)
+    encodeULEB128(*R.Hotness, OS);
+
+  encodeULEB128(R.Args.size(), OS);
+  for (const Argument &Arg : R.Args) {
+    emitString(Arg.Key);
+    emitString(Arg.Val);
+    encodeULEB128(Arg.Loc.hasValue(), OS);
+    if (Arg.Loc)
+      emitLocation(*Arg.Loc);
+  }
+}
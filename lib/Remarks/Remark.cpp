@@ -0,0 +1,51 @@
+//===- Remark.cpp - An optimization remark --------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/Remark.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/ErrorHandling.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+StringRef remarks::getTypeName(Type T) {
+  switch (T) {
+  case Type::Passed:
+    return "Passed";
+  case Type::Missed:
+    return "Missed";
+  case Type::Analysis:
+    return "Analysis";
+  case Type::AnalysisFPCommute:
+    return "AnalysisFPCommute";
+  case Type::AnalysisAliasing:
+    return "AnalysisAliasing";
+  case Type::Failure:
+    return "Failure";
+  }
+  llvm_unreachable("Unknown remark type");
+}
+
+Optional<Type> remarks::parseTypeName(StringRef Name) {
+  return StringSwitch<Optional<Type>>(Name)
+      .Case("Passed", Type::Passed)
+      .Case("Missed", Type::Missed)
+      .Case("Analysis", Type::Analysis)
+      .Case("AnalysisFPCommute", Type::AnalysisFPCommute)
+      .Case("AnalysisAliasing", Type::AnalysisAliasing)
+      .Case("Failure", Type::Failure)
+      .Default(None);
+}
+
+std::string Remark::getArgsAsMsg() const {
+  std::string Msg;
+  for (const Argument &Arg : Args)
+    Msg += Arg.Val;
+  return Msg;
+}
@@ -0,0 +1,71 @@
+//===- YAMLRemarkWriter.cpp - Write YAML remarks --------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// The mappings below follow the ones of DiagnosticInfoOptimizationBase in
+// lib/IR/DiagnosticInfo.cpp, so that remarks read back from a binary file are
+// written exactly as the compiler would have written them.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/YAMLRemarkWriter.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+namespace llvm {
+namespace yaml {
+
+template <> struct MappingTraits<RemarkLocation> {
+  static void mapping(IO &io, RemarkLocation &Loc) {
+    assert(io.outputting() && "input not yet implemented");
+    io.mapRequired("File", Loc.SourceFilePath);
+    io.mapRequired("Line", Loc.SourceLine);
+    io.mapRequired("Column", Loc.SourceColumn);
+  }
+
+  static const bool flow = true;
+};
+
+// Implement this as a mapping for now to get proper quotation for the value.
+template <> struct MappingTraits<Argument> {
+  static void mapping(IO &io, Argument &A) {
+    assert(io.outputting() && "input not yet implemented");
+    // The key of the mapping must be null-terminated.
+    std::string Key = A.Key;
+    io.mapRequired(Key.c_str(), A.Val);
+    if (A.Loc)
+      io.mapOptional("DebugLoc", *A.Loc);
+  }
+};
+
+template <> struct MappingTraits<Remark *> {
+  static void mapping(IO &io, Remark *&R) {
+    assert(io.outputting() && "input not yet implemented");
+    io.mapTag(("!" + getTypeName(R->RemarkType)).str(), true);
+    io.mapRequired("Pass", R->PassName);
+    io.mapRequired("Name", R->RemarkName);
+    if (R->Loc)
+      io.mapOptional("DebugLoc", *R->Loc);
+    io.mapRequired("Function", R->FunctionName);
+    io.mapOptional("Hotness", R->Hotness);
+    io.mapOptional("Args", R->Args);
+  }
+};
+
+} // end namespace yaml
+} // end namespace llvm
+
+LLVM_YAML_IS_SEQUENCE_VECTOR(Argument)
+
+void YAMLRemarkWriter::emit(const Remark &R) {
+  // The YAML output takes a reference to a pointer, but does not modify the
+  // remark.
+  auto *P = const_cast<Remark *>(&R);
+  YOut << P;
+}
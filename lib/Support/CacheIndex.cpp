@@ -0,0 +1,315 @@
+//===-CacheIndex.cpp - Indexed cache directory ----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the append-only index of a cache directory.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/CacheIndex.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/Errc.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <limits>
+
+#define DEBUG_TYPE "cache-index"
+
+using namespace llvm;
+
+// The index is a log of newline-terminated records:
+//
+//   A <time> <size> <key>   The entry for <key> was written after a miss.
+//   U <time> <size> <key>   The entry for <key> exists (compaction, adoption).
+//   H <time> <key>          The entry for <key> was hit.
+//   R <key>                 The entry for <key> was removed.
+//   S <hits> <misses> <evictions>
+//                           Counters carried over by compaction.
+//
+// Times are in seconds since the epoch. Lines that don't parse, such as a
+// record torn by a crash, are ignored.
+
+static uint64_t now() {
+  return sys::toTimeT(std::chrono::system_clock::now());
+}
+
+CacheIndex::CacheIndex(StringRef Path) : Path(Path) {
+  IndexPath = Path;
+  sys::path::append(IndexPath, "llvmcache.index");
+}
+
+CacheIndex::~CacheIndex() = default;
+
+Expected<std::unique_ptr<CacheIndex>> CacheIndex::open(StringRef Path) {
+  if (std::error_code EC = sys::fs::create_directories(Path))
+    return errorCodeToError(EC);
+
+  std::unique_ptr<CacheIndex> Index(new CacheIndex(Path));
+  if (Error E = Index->replay())
+    return std::move(E);
+  if (Error E = Index->openLog())
+    return std::move(E);
+  return std::move(Index);
+}
+
+std::string CacheIndex::getEntryPath(StringRef Key) const {
+  // This choice of file name allows the cache to be pruned by pruneCache() as
+  // well.
+  SmallString<128> EntryPath(Path);
+  sys::path::append(EntryPath, "llvmcache-" + Key);
+  return EntryPath.str();
+}
+
+Error CacheIndex::replay() {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(IndexPath, /*FileSize=*/-1,
+                            /*RequiresNullTerminator=*/false);
+  if (!MBOrErr) {
+    if (MBOrErr.getError() == errc::no_such_file_or_directory)
+      return Error::success();
+    return errorCodeToError(MBOrErr.getError());
+  }
+
+  SmallVector<StringRef, 4> Fields;
+  StringRef Rest = (*MBOrErr)->getBuffer();
+  while (!Rest.empty()) {
+    StringRef Line;
+    std::tie(Line, Rest) = Rest.split('\n');
+    // A line without its newline was torn while being appended.
+    if (Rest.empty() && !(*MBOrErr)->getBuffer().endswith("\n"))
+      break;
+    ++NumRecords;
+
+    Fields.clear();
+    Line.split(Fields, ' ');
+    uint64_t Time, Size;
+    switch (Fields.size() == 0 || Fields[0].size() != 1 ? 0 : Fields[0][0]) {
+    case 'A':
+    case 'U':
+      if (Fields.size() != 4 || Fields[1].getAsInteger(10, Time) ||
+          Fields[2].getAsInteger(10, Size))
+        break;
+      addEntry(Fields[3], Size, Time);
+      if (Fields[0][0] == 'A')
+        ++Stats.Misses;
+      break;
+    case 'H': {
+      if (Fields.size() != 3 || Fields[1].getAsInteger(10, Time))
+        break;
+      auto I = Entries.find(Fields[2]);
+      if (I != Entries.end())
+        touchEntry(*I, Time);
+      ++Stats.Hits;
+      break;
+    }
+    case 'R': {
+      if (Fields.size() != 2)
+        break;
+      auto I = Entries.find(Fields[1]);
+      if (I != Entries.end())
+        removeEntry(*I);
+      ++Stats.Evictions;
+      break;
+    }
+    case 'S': {
+      uint64_t Hits, Misses, Evictions;
+      if (Fields.size() != 4 || Fields[1].getAsInteger(10, Hits) ||
+          Fields[2].getAsInteger(10, Misses) ||
+          Fields[3].getAsInteger(10, Evictions))
+        break;
+      Stats.Hits += Hits;
+      Stats.Misses += Misses;
+      Stats.Evictions += Evictions;
+      break;
+    }
+    default:
+      LLVM_DEBUG(dbgs() << "Ignoring malformed index record '" << Line
+                        << "'\n");
+      break;
+    }
+  }
+  return Error::success();
+}
+
+Error CacheIndex::openLog() {
+  std::error_code EC;
+  Log = llvm::make_unique<raw_fd_ostream>(IndexPath, EC, sys::fs::F_Append);
+  if (EC) {
+    Log.reset();
+    return errorCodeToError(EC);
+  }
+  // Every record goes out in a single write, so that records appended by
+  // concurrent processes don't interleave.
+  Log->SetUnbuffered();
+  return Error::success();
+}
+
+void CacheIndex::appendRecord(StringRef Record) {
+  Log->write(Record.data(), Record.size());
+  ++NumRecords;
+}
+
+void CacheIndex::addEntry(StringRef Key, uint64_t Size, uint64_t Time) {
+  auto Result = Entries.insert({Key, Entry()});
+  StringMapEntry<Entry> &E = *Result.first;
+  if (Result.second) {
+    E.second.Size = 0;
+    E.second.LRUPos = LRU.insert(LRU.end(), &E);
+    ++Stats.NumEntries;
+  }
+  Stats.TotalSize = Stats.TotalSize - E.second.Size + Size;
+  E.second.Size = Size;
+  touchEntry(E, Time);
+}
+
+void CacheIndex::touchEntry(StringMapEntry<Entry> &E, uint64_t Time) {
+  E.second.LastAccess = Time;
+  LRU.splice(LRU.end(), LRU, E.second.LRUPos);
+}
+
+void CacheIndex::removeEntry(StringMapEntry<Entry> &E) {
+  LRU.erase(E.second.LRUPos);
+  Stats.TotalSize -= E.second.Size;
+  --Stats.NumEntries;
+  Entries.erase(E.getKey());
+}
+
+bool CacheIndex::lookup(StringRef Key) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  uint64_t Time = now();
+  auto I = Entries.find(Key);
+  if (I == Entries.end()) {
+    // The entry may have been added by another process after we read the
+    // index. Adopt it rather than rebuilding it.
+    sys::fs::file_status Status;
+    if (sys::fs::status(getEntryPath(Key), Status) ||
+        !sys::fs::is_regular_file(Status))
+      return false;
+    addEntry(Key, Status.getSize(), Time);
+    appendRecord(("U " + Twine(Time) + " " + Twine(Status.getSize()) + " " +
+                  Key + "\n")
+                     .str());
+  } else {
+    touchEntry(*I, Time);
+  }
+  ++Stats.Hits;
+  appendRecord(("H " + Twine(Time) + " " + Key + "\n").str());
+  maybeCompact();
+  return true;
+}
+
+void CacheIndex::insert(StringRef Key, uint64_t Size) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  uint64_t Time = now();
+  addEntry(Key, Size, Time);
+  ++Stats.Misses;
+  appendRecord(
+      ("A " + Twine(Time) + " " + Twine(Size) + " " + Key + "\n").str());
+  maybeCompact();
+}
+
+uint64_t CacheIndex::prune(const CachePruningPolicy &Policy) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  uint64_t Time = now();
+  uint64_t Expiration = Policy.Expiration.count();
+
+  // Work out the size target like pruneCache() does, from the space used by
+  // the cache and the space left on the disk.
+  const uint64_t Unknown = std::numeric_limits<uint64_t>::max();
+  uint64_t SizeTarget = 0;
+  unsigned Percentage =
+      std::min(Policy.MaxSizePercentageOfAvailableSpace, 100u);
+  if (Percentage > 0 || Policy.MaxSizeBytes > 0) {
+    uint64_t AvailableSpace = Unknown;
+    if (ErrorOr<sys::fs::space_info> SpaceInfo = sys::fs::disk_space(Path))
+      AvailableSpace = Stats.TotalSize + SpaceInfo->free;
+    SizeTarget = AvailableSpace;
+    if (Percentage > 0 && AvailableSpace != Unknown)
+      SizeTarget = AvailableSpace / 100 * Percentage;
+    if (Policy.MaxSizeBytes > 0)
+      SizeTarget = std::min(SizeTarget, Policy.MaxSizeBytes);
+  }
+
+  // Evict from the least recently used end until every limit is met. This
+  // only looks at the entries being evicted, plus one.
+  uint64_t NumRemoved = 0;
+  while (!LRU.empty()) {
+    StringMapEntry<Entry> &E = *LRU.front();
+    bool Expired =
+        Expiration != 0 && Time > E.second.LastAccess + Expiration;
+    bool TooMany =
+        Policy.MaxSizeFiles != 0 && Stats.NumEntries > Policy.MaxSizeFiles;
+    bool TooBig = SizeTarget != 0 && Stats.TotalSize > SizeTarget;
+    if (!Expired && !TooMany && !TooBig)
+      break;
+
+    std::string Key = E.getKey();
+    LLVM_DEBUG(dbgs() << "Remove " << getEntryPath(Key) << " (size "
+                      << E.second.Size << ", last used "
+                      << Time - E.second.LastAccess << "s ago)\n");
+    sys::fs::remove(getEntryPath(Key));
+    removeEntry(E);
+    ++Stats.Evictions;
+    appendRecord(("R " + Key + "\n"));
+    ++NumRemoved;
+  }
+  maybeCompact();
+  return NumRemoved;
+}
+
+CacheIndex::Statistics CacheIndex::getStatistics() const {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return Stats;
+}
+
+Error CacheIndex::compact() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  SmallString<128> TempPath;
+  int FD;
+  if (std::error_code EC = sys::fs::createUniqueFile(
+          IndexPath + "-%%%%%%.tmp", FD, TempPath))
+    return errorCodeToError(EC);
+
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << "S " << Stats.Hits << ' ' << Stats.Misses << ' ' << Stats.Evictions
+       << '\n';
+    for (StringMapEntry<Entry> *E : LRU)
+      OS << "U " << E->second.LastAccess << ' ' << E->second.Size << ' '
+         << E->getKey() << '\n';
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return make_error<StringError>("cannot write " + TempPath,
+                                     inconvertibleErrorCode());
+    }
+  }
+
+  // Renaming is atomic, so other processes either see the old log or the new
+  // one. Records they append to the old one after this point are lost.
+  if (std::error_code EC = sys::fs::rename(TempPath, IndexPath)) {
+    sys::fs::remove(TempPath);
+    return errorCodeToError(EC);
+  }
+  NumRecords = Entries.size() + 1;
+  return openLog();
+}
+
+void CacheIndex::maybeCompact() {
+  if (NumRecords <= 4 * Entries.size() + 1024)
+    return;
+  // compact() takes the lock itself.
+  Lock.unlock();
+  if (Error E = compact())
+    consumeError(std::move(E));
+  Lock.lock();
+}
@@ -12,23 +12,45 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/Compression.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Twine.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Compiler.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
+#include <algorithm>
+#include <vector>
 #if LLVM_ENABLE_ZLIB == 1 && HAVE_ZLIB_H
 #include <zlib.h>
 #endif
+#if LLVM_ENABLE_ZSTD == 1 && HAVE_ZSTD_H
+#include <zstd.h>
+#endif
+#if LLVM_ENABLE_LZ4 == 1 && HAVE_LZ4_H
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
 
 using namespace llvm;
 
-#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
-static Error createError(StringRef Err) {
+LLVM_ATTRIBUTE_UNUSED static Error createError(StringRef Err) {
   return make_error<StringError>(Err, inconvertibleErrorCode());
 }
 
+/// Append the pieces compressed by compressParallel to \p CompressedBuffer.
+LLVM_ATTRIBUTE_UNUSED static void
+appendPieces(ArrayRef<SmallVector<char, 0>> Pieces,
+             SmallVectorImpl<char> &CompressedBuffer) {
+  for (const SmallVector<char, 0> &Piece : Pieces)
+    CompressedBuffer.append(Piece.begin(), Piece.end());
+}
+
+#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
+
 static int encodeZlibCompressionLevel(zlib::CompressionLevel Level) {
   switch (Level) {
     case zlib::NoCompression: return 0;
@@ -98,6 +120,80 @@ uint32_t zlib::crc32(StringRef Buffer) {
   return ::crc32(0, (const Bytef *)Buffer.data(), Buffer.size());
 }
 
+/// Compress every chunk of \p InputBuffer to raw deflate data, and wrap the
+/// concatenation in a zlib header and trailer. All pieces but the last end
+/// with a full flush: an empty stored block that brings the stream to a byte
+/// boundary without marking the end of it, after which nothing refers back
+/// to earlier data.
+static Error compressZlibParallel(StringRef InputBuffer,
+                                  SmallVectorImpl<char> &CompressedBuffer,
+                                  zlib::CompressionLevel Level,
+                                  size_t ChunkSize) {
+  size_t NumChunks = (InputBuffer.size() + ChunkSize - 1) / ChunkSize;
+  std::vector<SmallVector<char, 0>> Pieces(NumChunks);
+  std::vector<uLong> Checksums(NumChunks);
+  std::vector<int> Results(NumChunks, Z_OK);
+  int CLevel = encodeZlibCompressionLevel(Level);
+
+  parallel::for_each_n(parallel::par, size_t(0), NumChunks, [&](size_t I) {
+    StringRef Chunk = InputBuffer.substr(I * ChunkSize, ChunkSize);
+    bool Last = I + 1 == NumChunks;
+    Checksums[I] = ::adler32(::adler32(0, Z_NULL, 0),
+                             (const Bytef *)Chunk.data(), Chunk.size());
+
+    z_stream Stream = {};
+    int Res = ::deflateInit2(&Stream, CLevel, Z_DEFLATED, /*windowBits=*/-15,
+                             /*memLevel=*/8, Z_DEFAULT_STRATEGY);
+    if (Res != Z_OK) {
+      Results[I] = Res;
+      return;
+    }
+    SmallVector<char, 0> &Piece = Pieces[I];
+    // Leave room for the flush on top of the bound for Z_FINISH.
+    Piece.resize(::deflateBound(&Stream, Chunk.size()) + 16);
+    Stream.next_in = (Bytef *)Chunk.data();
+    Stream.avail_in = Chunk.size();
+    Stream.next_out = (Bytef *)Piece.data();
+    Stream.avail_out = Piece.size();
+    Res = ::deflate(&Stream, Last ? Z_FINISH : Z_FULL_FLUSH);
+    if (Last ? Res != Z_STREAM_END
+             : Res != Z_OK || Stream.avail_in != 0 || Stream.avail_out == 0)
+      Results[I] = Res == Z_OK || Res == Z_STREAM_END ? Z_BUF_ERROR : Res;
+    __msan_unpoison(Piece.data(), Stream.total_out);
+    Piece.resize(Stream.total_out);
+    ::deflateEnd(&Stream);
+  });
+
+  for (int Res : Results)
+    if (Res != Z_OK)
+      return createError(convertZlibCodeToString(Res));
+
+  // The header records the compression level the way compress2 does.
+  unsigned LevelFlags = 3;
+  if (CLevel == Z_DEFAULT_COMPRESSION || CLevel == 6)
+    LevelFlags = 2;
+  else if (CLevel < 2)
+    LevelFlags = 0;
+  else if (CLevel < 6)
+    LevelFlags = 1;
+  uint16_t Header = (0x78 << 8) | (LevelFlags << 6);
+  Header += 31 - Header % 31;
+  uLong Checksum = Checksums[0];
+  for (size_t I = 1; I != NumChunks; ++I)
+    Checksum = ::adler32_combine(
+        Checksum, Checksums[I],
+        std::min(ChunkSize, InputBuffer.size() - I * ChunkSize));
+
+  CompressedBuffer.clear();
+  char Buf[4];
+  support::endian::write16be(Buf, Header);
+  CompressedBuffer.append(Buf, Buf + 2);
+  appendPieces(Pieces, CompressedBuffer);
+  support::endian::write32be(Buf, Checksum);
+  CompressedBuffer.append(Buf, Buf + 4);
+  return Error::success();
+}
+
 #else
 bool zlib::isAvailable() { return false; }
 Error zlib::compress(StringRef InputBuffer,
@@ -119,3 +215,299 @@ uint32_t zlib::crc32(StringRef Buffer) {
 }
 #endif
 
+#if LLVM_ENABLE_ZSTD == 1 && HAVE_LIBZSTD
+static int encodeZstdCompressionLevel(compression::CompressionLevel Level) {
+  switch (Level) {
+    // zstd has no level that only stores the data.
+    case compression::NoCompression: return 1;
+    case compression::BestSpeedCompression: return 1;
+    case compression::DefaultCompression: return ZSTD_CLEVEL_DEFAULT;
+    case compression::BestSizeCompression: return 19;
+  }
+  llvm_unreachable("Invalid compression::CompressionLevel!");
+}
+
+static Error createZstdError(size_t Code) {
+  return createError((Twine("zstd error: ") + ::ZSTD_getErrorName(Code)).str());
+}
+
+bool zstd::isAvailable() { return true; }
+
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer,
+                     compression::CompressionLevel Level) {
+  CompressedBuffer.resize(::ZSTD_compressBound(InputBuffer.size()));
+  size_t Res = ::ZSTD_compress(CompressedBuffer.data(), CompressedBuffer.size(),
+                               InputBuffer.data(), InputBuffer.size(),
+                               encodeZstdCompressionLevel(Level));
+  if (::ZSTD_isError(Res))
+    return createZstdError(Res);
+  __msan_unpoison(CompressedBuffer.data(), Res);
+  CompressedBuffer.resize(Res);
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  // Split the input into frames. If it has several and their headers record
+  // their sizes, which is the case for those written by compressParallel,
+  // each frame can be uncompressed independently.
+  SmallVector<std::pair<StringRef, size_t>, 8> Frames;
+  size_t Total = 0;
+  for (StringRef Rest = InputBuffer; !Rest.empty();) {
+    size_t FrameSize = ::ZSTD_findFrameCompressedSize(Rest.data(), Rest.size());
+    if (::ZSTD_isError(FrameSize))
+      return createZstdError(FrameSize);
+    unsigned long long ContentSize =
+        ::ZSTD_getFrameContentSize(Rest.data(), FrameSize);
+    if (ContentSize == ZSTD_CONTENTSIZE_UNKNOWN ||
+        ContentSize == ZSTD_CONTENTSIZE_ERROR ||
+        ContentSize > UncompressedSize - Total) {
+      Frames.clear();
+      break;
+    }
+    Frames.push_back({Rest.take_front(FrameSize), ContentSize});
+    Total += ContentSize;
+    Rest = Rest.drop_front(FrameSize);
+  }
+
+  if (Frames.size() > 1) {
+    std::vector<size_t> Offsets(Frames.size());
+    for (size_t I = 1, E = Frames.size(); I != E; ++I)
+      Offsets[I] = Offsets[I - 1] + Frames[I - 1].second;
+    std::vector<size_t> Results(Frames.size());
+    parallel::for_each_n(parallel::par, size_t(0), Frames.size(),
+                         [&](size_t I) {
+                           StringRef Frame = Frames[I].first;
+                           Results[I] = ::ZSTD_decompress(
+                               UncompressedBuffer + Offsets[I],
+                               Frames[I].second, Frame.data(), Frame.size());
+                         });
+    for (size_t Res : Results)
+      if (::ZSTD_isError(Res))
+        return createZstdError(Res);
+    __msan_unpoison(UncompressedBuffer, Total);
+    UncompressedSize = Total;
+    return Error::success();
+  }
+
+  size_t Res = ::ZSTD_decompress(UncompressedBuffer, UncompressedSize,
+                                 InputBuffer.data(), InputBuffer.size());
+  if (::ZSTD_isError(Res))
+    return createZstdError(Res);
+  __msan_unpoison(UncompressedBuffer, Res);
+  UncompressedSize = Res;
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  UncompressedBuffer.resize(UncompressedSize);
+  Error E =
+      uncompress(InputBuffer, UncompressedBuffer.data(), UncompressedSize);
+  UncompressedBuffer.resize(UncompressedSize);
+  return E;
+}
+
+/// Compress every chunk of \p InputBuffer to a frame of its own. A sequence
+/// of frames is a valid zstd stream.
+static Error compressZstdParallel(StringRef InputBuffer,
+                                  SmallVectorImpl<char> &CompressedBuffer,
+                                  compression::CompressionLevel Level,
+                                  size_t ChunkSize) {
+  size_t NumChunks = (InputBuffer.size() + ChunkSize - 1) / ChunkSize;
+  std::vector<SmallVector<char, 0>> Pieces(NumChunks);
+  std::vector<size_t> Results(NumChunks);
+  int CLevel = encodeZstdCompressionLevel(Level);
+
+  parallel::for_each_n(parallel::par, size_t(0), NumChunks, [&](size_t I) {
+    StringRef Chunk = InputBuffer.substr(I * ChunkSize, ChunkSize);
+    SmallVector<char, 0> &Piece = Pieces[I];
+    Piece.resize(::ZSTD_compressBound(Chunk.size()));
+    Results[I] = ::ZSTD_compress(Piece.data(), Piece.size(), Chunk.data(),
+                                 Chunk.size(), CLevel);
+    if (!::ZSTD_isError(Results[I])) {
+      __msan_unpoison(Piece.data(), Results[I]);
+      Piece.resize(Results[I]);
+    }
+  });
+
+  for (size_t Res : Results)
+    if (::ZSTD_isError(Res))
+      return createZstdError(Res);
+  CompressedBuffer.clear();
+  appendPieces(Pieces, CompressedBuffer);
+  return Error::success();
+}
+
+#else
+bool zstd::isAvailable() { return false; }
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer,
+                     compression::CompressionLevel Level) {
+  llvm_unreachable("zstd::compress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+#endif
+
+#if LLVM_ENABLE_LZ4 == 1 && HAVE_LIBLZ4
+bool lz4::isAvailable() { return true; }
+
+Error lz4::compress(StringRef InputBuffer,
+                    SmallVectorImpl<char> &CompressedBuffer,
+                    compression::CompressionLevel Level) {
+  if (InputBuffer.size() > LZ4_MAX_INPUT_SIZE)
+    return createError("lz4 error: input too large");
+  int Size = InputBuffer.size();
+  CompressedBuffer.resize(::LZ4_compressBound(Size));
+  int Capacity = CompressedBuffer.size();
+  int Res = 0;
+  switch (Level) {
+  case compression::BestSizeCompression:
+    Res = ::LZ4_compress_HC(InputBuffer.data(), CompressedBuffer.data(), Size,
+                            Capacity, LZ4HC_CLEVEL_MAX);
+    break;
+  case compression::BestSpeedCompression:
+    Res = ::LZ4_compress_fast(InputBuffer.data(), CompressedBuffer.data(),
+                              Size, Capacity, /*acceleration=*/8);
+    break;
+  case compression::NoCompression:
+  case compression::DefaultCompression:
+    Res = ::LZ4_compress_default(InputBuffer.data(), CompressedBuffer.data(),
+                                 Size, Capacity);
+    break;
+  }
+  if (Res <= 0 && Size != 0)
+    return createError("lz4 error: compression failed");
+  __msan_unpoison(CompressedBuffer.data(), Res);
+  CompressedBuffer.resize(Res);
+  return Error::success();
+}
+
+Error lz4::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                      size_t &UncompressedSize) {
+  int Capacity = std::min<size_t>(UncompressedSize, LZ4_MAX_INPUT_SIZE);
+  int Res = ::LZ4_decompress_safe(InputBuffer.data(), UncompressedBuffer,
+                                  InputBuffer.size(), Capacity);
+  if (Res < 0)
+    return createError("lz4 error: malformed input or output too small");
+  __msan_unpoison(UncompressedBuffer, Res);
+  UncompressedSize = Res;
+  return Error::success();
+}
+
+Error lz4::uncompress(StringRef InputBuffer,
+                      SmallVectorImpl<char> &UncompressedBuffer,
+                      size_t UncompressedSize) {
+  UncompressedBuffer.resize(UncompressedSize);
+  Error E =
+      uncompress(InputBuffer, UncompressedBuffer.data(), UncompressedSize);
+  UncompressedBuffer.resize(UncompressedSize);
+  return E;
+}
+
+#else
+bool lz4::isAvailable() { return false; }
+Error lz4::compress(StringRef InputBuffer,
+                    SmallVectorImpl<char> &CompressedBuffer,
+                    compression::CompressionLevel Level) {
+  llvm_unreachable("lz4::compress is unavailable");
+}
+Error lz4::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                      size_t &UncompressedSize) {
+  llvm_unreachable("lz4::uncompress is unavailable");
+}
+Error lz4::uncompress(StringRef InputBuffer,
+                      SmallVectorImpl<char> &UncompressedBuffer,
+                      size_t UncompressedSize) {
+  llvm_unreachable("lz4::uncompress is unavailable");
+}
+#endif
+
+StringRef compression::getName(Format F) {
+  switch (F) {
+  case Format::Zlib: return "zlib";
+  case Format::Zstd: return "zstd";
+  case Format::LZ4: return "lz4";
+  }
+  llvm_unreachable("Invalid compression::Format!");
+}
+
+bool compression::isAvailable(Format F) {
+  switch (F) {
+  case Format::Zlib: return zlib::isAvailable();
+  case Format::Zstd: return zstd::isAvailable();
+  case Format::LZ4: return lz4::isAvailable();
+  }
+  llvm_unreachable("Invalid compression::Format!");
+}
+
+Error compression::compress(Format F, StringRef InputBuffer,
+                            SmallVectorImpl<char> &CompressedBuffer,
+                            CompressionLevel Level) {
+  switch (F) {
+  case Format::Zlib:
+    return zlib::compress(InputBuffer, CompressedBuffer, Level);
+  case Format::Zstd:
+    return zstd::compress(InputBuffer, CompressedBuffer, Level);
+  case Format::LZ4:
+    return lz4::compress(InputBuffer, CompressedBuffer, Level);
+  }
+  llvm_unreachable("Invalid compression::Format!");
+}
+
+Error compression::uncompress(Format F, StringRef InputBuffer,
+                              char *UncompressedBuffer,
+                              size_t &UncompressedSize) {
+  switch (F) {
+  case Format::Zlib:
+    return zlib::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  case Format::Zstd:
+    return zstd::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  case Format::LZ4:
+    return lz4::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  }
+  llvm_unreachable("Invalid compression::Format!");
+}
+
+Error compression::uncompress(Format F, StringRef InputBuffer,
+                              SmallVectorImpl<char> &UncompressedBuffer,
+                              size_t UncompressedSize) {
+  switch (F) {
+  case Format::Zlib:
+    return zlib::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  case Format::Zstd:
+    return zstd::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  case Format::LZ4:
+    return lz4::uncompress(InputBuffer, UncompressedBuffer, UncompressedSize);
+  }
+  llvm_unreachable("Invalid compression::Format!");
+}
+
+Error compression::compressParallel(Format F, StringRef InputBuffer,
+                                    SmallVectorImpl<char> &CompressedBuffer,
+                                    CompressionLevel Level, size_t ChunkSize) {
+  assert(ChunkSize != 0 && "Invalid chunk size");
+  if (InputBuffer.size() > ChunkSize) {
+#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
+    if (F == Format::Zlib)
+      return compressZlibParallel(InputBuffer, CompressedBuffer, Level,
+                                  ChunkSize);
+#endif
+#if LLVM_ENABLE_ZSTD == 1 && HAVE_LIBZSTD
+    if (F == Format::Zstd)
+      return compressZstdParallel(InputBuffer, CompressedBuffer, Level,
+                                  ChunkSize);
+#endif
+  }
+  return compress(F, InputBuffer, CompressedBuffer, Level);
+}
@@ -10,6 +10,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Host.h"
+#include "llvm/Support/LEB128.h"
 #include "llvm/Support/SwapByteOrder.h"
 using namespace llvm;
 
@@ -190,3 +191,33 @@ int64_t DataExtractor::getSLEB128(uint32_t *offset_ptr) const {
   *offset_ptr = offset;
   return result;
 }
+
+void DataExtractor::getSLEB128(uint32_t *offset_ptr, int64_t *dst,
+                               uint32_t count) const {
+  uint32_t n = 0;
+  if (isValidOffset(*offset_ptr)) {
+    size_t bytes = 0;
+    n = decodeSLEB128Array(Data.bytes_begin() + *offset_ptr, Data.bytes_end(),
+                           dst, count, &bytes);
+    *offset_ptr += bytes;
+  }
+  // The bulk decoder stops at values running off the end of the data, which
+  // getSLEB128() truncates.
+  for (; n != count; ++n)
+    dst[n] = getSLEB128(offset_ptr);
+}
+
+void DataExtractor::getULEB128(uint32_t *offset_ptr, uint64_t *dst,
+                               uint32_t count) const {
+  uint32_t n = 0;
+  if (isValidOffset(*offset_ptr)) {
+    size_t bytes = 0;
+    n = decodeULEB128Array(Data.bytes_begin() + *offset_ptr, Data.bytes_end(),
+                           dst, count, &bytes);
+    *offset_ptr += bytes;
+  }
+  // The bulk decoder stops at values running off the end of the data, which
+  // getULEB128() truncates, and at values that overflow, which it wraps.
+  for (; n != count; ++n)
+    dst[n] = getULEB128(offset_ptr);
+}
@@ -8,14 +8,260 @@
 //===----------------------------------------------------------------------===//
 //
 // This file implements some utility functions for encoding SLEB128 and
-// ULEB128 values.
+// ULEB128 values, and the bulk decoders.
 //
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/LEB128.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MathExtras.h"
+#include <algorithm>
+
+// The SSE4.1 and AVX2 kernels are compiled with target attributes, so that
+// they can be selected at runtime without building all of LLVM for them.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LLVM_LEB128_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace llvm;
+
+// A kernel decodes values from p for as long as it can do so cheaply,
+// advancing p past them, and returns how many it decoded. Values that are long,
+// possibly malformed, or too close to the end of the buffer are left to the
+// scalar decoders. Signed values are returned as their two's complement bit
+// patterns.
+using LEB128Kernel = size_t (*)(const uint8_t *&p, const uint8_t *end,
+                                uint64_t *Out, size_t Count);
+
+/// Decode the well formed, at most 9 byte long, value of \p Len bytes at \p p.
+template <bool Signed>
+static uint64_t decodeShortLEB128(const uint8_t *p, unsigned Len) {
+  uint64_t Value = 0;
+  for (unsigned I = 0; I != Len; ++I)
+    Value |= uint64_t(p[I] & 0x7f) << (7 * I);
+  if (Signed && (p[Len - 1] & 0x40))
+    Value |= -1ULL << (7 * Len);
+  return Value;
+}
+
+/// Decode values from the block of \p BlockSize bytes at \p p, given the mask
+/// \p Cont of the bytes in it that have their continuation bit set: the
+/// one-byte values up to the first multi-byte value, and that value if it
+/// ends within the block.
+template <bool Signed>
+static size_t decodeLEB128Block(const uint8_t *&p, uint64_t Cont,
+                                unsigned BlockSize, uint64_t *Out,
+                                size_t Count) {
+  unsigned Run = Cont ? countTrailingZeros(Cont) : BlockSize;
+  size_t N = std::min<size_t>(Run, Count);
+  for (size_t I = 0; I != N; ++I)
+    Out[I] = Signed ? SignExtend64<7>(p[I]) : p[I];
+  p += N;
+  if (N == Count || Run == BlockSize)
+    return N;
+
+  // p is at a multi-byte value. It ends at the next byte without a
+  // continuation bit. Anything longer than 9 bytes may overflow.
+  uint64_t Stop = ~Cont & maskTrailingOnes<uint64_t>(BlockSize) &
+                  (~0ULL << Run);
+  unsigned Len = Stop ? countTrailingZeros(Stop) - Run + 1 : 0;
+  if (Len == 0 || Len > 9)
+    return N;
+  Out[N] = decodeShortLEB128<Signed>(p, Len);
+  p += Len;
+  return N + 1;
+}
+
+/// The portable kernel works on 8 bytes at a time.
+template <bool Signed>
+static size_t decodeLEB128Generic(const uint8_t *&p, const uint8_t *end,
+                                  uint64_t *Out, size_t Count) {
+  size_t Done = 0;
+  while (Done != Count && end - p >= 8) {
+    // Gather the continuation bits of the 8 bytes into the low byte.
+    uint64_t Word = support::endian::read64le(p);
+    uint64_t Cont =
+        ((Word & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56;
+    size_t N = decodeLEB128Block<Signed>(p, Cont, 8, Out + Done, Count - Done);
+    if (N == 0)
+      break;
+    Done += N;
+  }
+  return Done;
+}
+
+#ifdef LLVM_LEB128_X86
+/// Widen the one-byte values in the low 2 bytes of \p Bytes into \p Out.
+template <bool Signed>
+__attribute__((target("sse4.1"))) static inline void
+storeWidened2(uint64_t *Out, __m128i Bytes) {
+  __m128i V = Signed ? _mm_cvtepi8_epi64(Bytes) : _mm_cvtepu8_epi64(Bytes);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(Out), V);
+}
+
+/// Widen the one-byte values in the low 4 bytes of \p Bytes into \p Out.
+template <bool Signed>
+__attribute__((target("avx2"))) static inline void
+storeWidened4(uint64_t *Out, __m128i Bytes) {
+  __m256i V =
+      Signed ? _mm256_cvtepi8_epi64(Bytes) : _mm256_cvtepu8_epi64(Bytes);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(Out), V);
+}
+
+/// The SSE4.1 kernel works on 16 bytes at a time.
+template <bool Signed>
+__attribute__((target("sse4.1"))) static size_t
+decodeLEB128SSE41(const uint8_t *&p, const uint8_t *end, uint64_t *Out,
+                  size_t Count) {
+  size_t Done = 0;
+  while (Done != Count && end - p >= 16) {
+    __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    unsigned Cont = _mm_movemask_epi8(Bytes);
+    if (Cont == 0 && Count - Done >= 16) {
+      if (Signed) {
+        // Copy bit 6, the sign of a one-byte value, into bit 7 so that the
+        // bytes can be sign extended.
+        __m128i Sign = _mm_and_si128(Bytes, _mm_set1_epi8(0x40));
+        Bytes = _mm_or_si128(Bytes, _mm_add_epi8(Sign, Sign));
+      }
+      uint64_t *Dst = Out + Done;
+      storeWidened2<Signed>(Dst, Bytes);
+      storeWidened2<Signed>(Dst + 2, _mm_srli_si128(Bytes, 2));
+      storeWidened2<Signed>(Dst + 4, _mm_srli_si128(Bytes, 4));
+      storeWidened2<Signed>(Dst + 6, _mm_srli_si128(Bytes, 6));
+      storeWidened2<Signed>(Dst + 8, _mm_srli_si128(Bytes, 8));
+      storeWidened2<Signed>(Dst + 10, _mm_srli_si128(Bytes, 10));
+      storeWidened2<Signed>(Dst + 12, _mm_srli_si128(Bytes, 12));
+      storeWidened2<Signed>(Dst + 14, _mm_srli_si128(Bytes, 14));
+      p += 16;
+      Done += 16;
+      continue;
+    }
+    size_t N = decodeLEB128Block<Signed>(p, Cont, 16, Out + Done, Count - Done);
+    if (N == 0)
+      break;
+    Done += N;
+  }
+  return Done;
+}
+
+/// The AVX2 kernel works on 32 bytes at a time.
+template <bool Signed>
+__attribute__((target("avx2"))) static size_t
+decodeLEB128AVX2(const uint8_t *&p, const uint8_t *end, uint64_t *Out,
+                 size_t Count) {
+  size_t Done = 0;
+  while (Done != Count && end - p >= 32) {
+    __m256i Bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    uint32_t Cont = _mm256_movemask_epi8(Bytes);
+    if (Cont == 0 && Count - Done >= 32) {
+      if (Signed) {
+        __m256i Sign = _mm256_and_si256(Bytes, _mm256_set1_epi8(0x40));
+        Bytes = _mm256_or_si256(Bytes, _mm256_add_epi8(Sign, Sign));
+      }
+      __m128i Lo = _mm256_castsi256_si128(Bytes);
+      __m128i Hi = _mm256_extracti128_si256(Bytes, 1);
+      uint64_t *Dst = Out + Done;
+      storeWidened4<Signed>(Dst, Lo);
+      storeWidened4<Signed>(Dst + 4, _mm_srli_si128(Lo, 4));
+      storeWidened4<Signed>(Dst + 8, _mm_srli_si128(Lo, 8));
+      storeWidened4<Signed>(Dst + 12, _mm_srli_si128(Lo, 12));
+      storeWidened4<Signed>(Dst + 16, Hi);
+      storeWidened4<Signed>(Dst + 20, _mm_srli_si128(Hi, 4));
+      storeWidened4<Signed>(Dst + 24, _mm_srli_si128(Hi, 8));
+      storeWidened4<Signed>(Dst + 28, _mm_srli_si128(Hi, 12));
+      p += 32;
+      Done += 32;
+      continue;
+    }
+    size_t N = decodeLEB128Block<Signed>(p, Cont, 32, Out + Done, Count - Done);
+    if (N == 0)
+      break;
+    Done += N;
+  }
+  return Done;
+}
+#endif // LLVM_LEB128_X86
+
+namespace {
+struct LEB128Kernels {
+  LEB128Kernel ULEB = decodeLEB128Generic<false>;
+  LEB128Kernel SLEB = decodeLEB128Generic<true>;
+
+  LEB128Kernels() {
+#ifdef LLVM_LEB128_X86
+    StringMap<bool> Features;
+    if (!sys::getHostCPUFeatures(Features))
+      return;
+    if (Features.lookup("avx2")) {
+      ULEB = decodeLEB128AVX2<false>;
+      SLEB = decodeLEB128AVX2<true>;
+    } else if (Features.lookup("sse4.1")) {
+      ULEB = decodeLEB128SSE41<false>;
+      SLEB = decodeLEB128SSE41<true>;
+    }
+#endif
+  }
+};
+} // end anonymous namespace
+
+/// Return the kernels for the host, which are picked on first use.
+static const LEB128Kernels &getKernels() {
+  static const LEB128Kernels Kernels;
+  return Kernels;
+}
+
+template <bool Signed>
+static size_t decodeLEB128Array(LEB128Kernel Kernel, const uint8_t *p,
+                                const uint8_t *end, uint64_t *Out,
+                                size_t Count, size_t *n, const char **error) {
+  const uint8_t *orig_p = p;
+  if (error)
+    *error = nullptr;
+  size_t Done = 0;
+  while (Done != Count) {
+    Done += Kernel(p, end, Out + Done, Count - Done);
+    // The portable kernel takes over close to the end of the buffer.
+    Done += decodeLEB128Generic<Signed>(p, end, Out + Done, Count - Done);
+    if (Done == Count)
+      break;
+
+    unsigned Len = 0;
+    const char *Error = nullptr;
+    Out[Done] = Signed ? decodeSLEB128(p, &Len, end, &Error)
+                       : decodeULEB128(p, &Len, end, &Error);
+    if (Error) {
+      if (error)
+        *error = Error;
+      break;
+    }
+    p += Len;
+    ++Done;
+  }
+  if (n)
+    *n = p - orig_p;
+  return Done;
+}
 
 namespace llvm {
 
+size_t decodeULEB128Array(const uint8_t *p, const uint8_t *end, uint64_t *Out,
+                          size_t Count, size_t *n, const char **error) {
+  return decodeLEB128Array<false>(getKernels().ULEB, p, end, Out, Count, n,
+                                  error);
+}
+
+size_t decodeSLEB128Array(const uint8_t *p, const uint8_t *end, int64_t *Out,
+                          size_t Count, size_t *n, const char **error) {
+  // Signed and unsigned variants of a type may alias.
+  return decodeLEB128Array<true>(getKernels().SLEB, p, end,
+                                 reinterpret_cast<uint64_t *>(Out), Count, n,
+                                 error);
+}
+
 /// Utility function to get the size of the ULEB128-encoded value.
 unsigned getULEB128Size(uint64_t Value) {
   unsigned Size = 0;
@@ -13,10 +13,7 @@
 #if LLVM_ENABLE_THREADS
 
 #include "llvm/Support/Threading.h"
-
-#include <atomic>
-#include <stack>
-#include <thread>
+#include "llvm/Support/WorkStealingExecutor.h"
 
 using namespace llvm;
 
@@ -28,6 +25,12 @@ public:
   virtual ~Executor() = default;
   virtual void add(std::function<void()> func) = 0;
 
+  /// Block until \p L reaches zero.
+  virtual void wait(const parallel::detail::Latch &L) { L.sync(); }
+
+  /// Called after a task brought a latch down to zero.
+  virtual void latchDone() {}
+
   static Executor *getDefaultExecutor();
 };
 
@@ -59,57 +62,27 @@ Executor *Executor::getDefaultExecutor() {
 }
 
 #else
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a work-stealing
+///   thread pool.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(unsigned ThreadCount = hardware_concurrency())
-      : Done(ThreadCount) {
-    // Spawn all but one of the threads in another thread as spawning threads
-    // can take a while.
-    std::thread([&, ThreadCount] {
-      for (size_t i = 1; i < ThreadCount; ++i) {
-        std::thread([=] { work(); }).detach();
-      }
-      work();
-    }).detach();
-  }
+      : Pool(ThreadCount) {}
 
-  ~ThreadPoolExecutor() override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    Stop = true;
-    Lock.unlock();
-    Cond.notify_all();
-    // Wait for ~Latch.
-  }
+  void add(std::function<void()> F) override { Pool.add(std::move(F)); }
 
-  void add(std::function<void()> F) override {
-    std::unique_lock<std::mutex> Lock(Mutex);
-    WorkStack.push(F);
-    Lock.unlock();
-    Cond.notify_one();
+  void wait(const parallel::detail::Latch &L) override {
+    // Threads outside the pool just block. A worker must keep running tasks,
+    // as the ones it waits for may be sitting in its own deque.
+    if (!Pool.isWorkerThread())
+      return L.sync();
+    Pool.helpUntil([&] { return L.isDone(); });
   }
 
-private:
-  void work() {
-    while (true) {
-      std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] { return Stop || !WorkStack.empty(); });
-      if (Stop)
-        break;
-      auto Task = WorkStack.top();
-      WorkStack.pop();
-      Lock.unlock();
-      Task();
-    }
-    Done.dec();
-  }
+  void latchDone() override { Pool.notifyWaiters(); }
 
-  std::atomic<bool> Stop{false};
-  std::stack<std::function<void()>> WorkStack;
-  std::mutex Mutex;
-  std::condition_variable Cond;
-  parallel::detail::Latch Done;
+private:
+  WorkStealingExecutor Pool;
 };
 
 Executor *Executor::getDefaultExecutor() {
@@ -121,9 +94,16 @@ Executor *Executor::getDefaultExecutor() {
 
 void parallel::detail::TaskGroup::spawn(std::function<void()> F) {
   L.inc();
-  Executor::getDefaultExecutor()->add([&, F] {
+  Executor *E = Executor::getDefaultExecutor();
+  E->add([&, E, F] {
     F();
-    L.dec();
+    // Don't touch this TaskGroup after the latch hits zero: it may be gone.
+    if (L.dec())
+      E->latchDone();
   });
 }
+
+void parallel::detail::TaskGroup::sync() const {
+  Executor::getDefaultExecutor()->wait(L);
+}
 #endif // LLVM_ENABLE_THREADS
@@ -0,0 +1,169 @@
+//===- llvm/Support/WorkStealingExecutor.cpp - Work-stealing executor -----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/WorkStealingExecutor.h"
+
+#if LLVM_ENABLE_THREADS
+
+#include "llvm/Support/Compiler.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace llvm;
+
+/// The executor the current thread is a worker of, if any, and the index of
+/// the deque it owns.
+static LLVM_THREAD_LOCAL WorkStealingExecutor *CurrentExecutor = nullptr;
+static LLVM_THREAD_LOCAL unsigned CurrentQueue = 0;
+
+WorkStealingExecutor::WorkStealingExecutor(unsigned ThreadCount) {
+  // Keep at least one deque around so that add() always has somewhere to put
+  // a task. With no workers such a task only runs if somebody helps.
+  Queues.reserve(std::max(ThreadCount, 1u));
+  for (unsigned I = 0, E = std::max(ThreadCount, 1u); I != E; ++I)
+    Queues.push_back(llvm::make_unique<WorkQueue>());
+
+  Threads.reserve(ThreadCount);
+  for (unsigned I = 0; I != ThreadCount; ++I)
+    Threads.emplace_back([this, I] { work(I); });
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  {
+    std::unique_lock<std::mutex> LockGuard(SleepLock);
+    Stop = true;
+  }
+  SleepCondition.notify_all();
+  for (auto &Worker : Threads)
+    Worker.join();
+}
+
+bool WorkStealingExecutor::isWorkerThread() const {
+  return CurrentExecutor == this;
+}
+
+void WorkStealingExecutor::add(TaskTy Task) {
+  unsigned Index = isWorkerThread() ? CurrentQueue
+                                    : NextQueue++ % Queues.size();
+  ++Outstanding;
+  {
+    std::lock_guard<std::mutex> LockGuard(Queues[Index]->Lock);
+    Queues[Index]->Tasks.push_back(std::move(Task));
+  }
+  ++Queued;
+
+  // A sleeper increments Sleepers before checking Queued, and we increment
+  // Queued before checking Sleepers, so at least one of us sees the other.
+  // Taking the lock orders the notification after the sleeper's wait.
+  if (Sleepers) {
+    { std::lock_guard<std::mutex> LockGuard(SleepLock); }
+    SleepCondition.notify_one();
+  }
+}
+
+bool WorkStealingExecutor::getTask(unsigned Index, TaskTy &Task) {
+  unsigned NumQueues = Queues.size();
+
+  // Our own deque first, newest task first.
+  if (Index < NumQueues) {
+    WorkQueue &Q = *Queues[Index];
+    std::lock_guard<std::mutex> LockGuard(Q.Lock);
+    if (!Q.Tasks.empty()) {
+      Task = std::move(Q.Tasks.back());
+      Q.Tasks.pop_back();
+      --Queued;
+      return true;
+    }
+  }
+
+  // Then steal the oldest task of somebody else, starting with our neighbour
+  // so that thieves spread over the victims.
+  unsigned Start = Index < NumQueues ? Index + 1 : NextQueue.load();
+  for (unsigned I = 0; I != NumQueues; ++I) {
+    unsigned Victim = (Start + I) % NumQueues;
+    if (Victim == Index)
+      continue;
+    WorkQueue &Q = *Queues[Victim];
+    std::lock_guard<std::mutex> LockGuard(Q.Lock);
+    if (Q.Tasks.empty())
+      continue;
+    Task = std::move(Q.Tasks.front());
+    Q.Tasks.pop_front();
+    --Queued;
+    return true;
+  }
+  return false;
+}
+
+void WorkStealingExecutor::runTask(TaskTy &Task) {
+  Task();
+  // Destroy the closure before signaling completion, as it may hold on to
+  // state owned by whoever waits on us.
+  Task = nullptr;
+  if (--Outstanding == 0) {
+    { std::lock_guard<std::mutex> LockGuard(CompletionLock); }
+    CompletionCondition.notify_all();
+  }
+}
+
+bool WorkStealingExecutor::runOne() {
+  TaskTy Task;
+  if (!getTask(isWorkerThread() ? CurrentQueue : ~0U, Task))
+    return false;
+  runTask(Task);
+  return true;
+}
+
+void WorkStealingExecutor::sleepUntil(function_ref<bool()> Done) {
+  std::unique_lock<std::mutex> LockGuard(SleepLock);
+  ++Sleepers;
+  SleepCondition.wait(LockGuard, [&] { return Done() || Queued; });
+  --Sleepers;
+}
+
+void WorkStealingExecutor::helpUntil(function_ref<bool()> Done) {
+  while (!Done()) {
+    if (runOne())
+      continue;
+    sleepUntil(Done);
+  }
+}
+
+void WorkStealingExecutor::notifyWaiters() {
+  { std::lock_guard<std::mutex> LockGuard(SleepLock); }
+  SleepCondition.notify_all();
+}
+
+void WorkStealingExecutor::wait() {
+  assert(!isWorkerThread() && "Waiting on the executor from one of its tasks");
+  std::unique_lock<std::mutex> LockGuard(CompletionLock);
+  CompletionCondition.wait(LockGuard, [&] { return Outstanding == 0; });
+}
+
+void WorkStealingExecutor::work(unsigned Index) {
+  CurrentExecutor = this;
+  CurrentQueue = Index;
+  while (true) {
+    TaskTy Task;
+    if (getTask(Index, Task)) {
+      runTask(Task);
+      continue;
+    }
+    std::unique_lock<std::mutex> LockGuard(SleepLock);
+    ++Sleepers;
+    SleepCondition.wait(LockGuard, [&] { return Stop || Queued; });
+    --Sleepers;
+    // Exit condition: drain the deques before leaving.
+    if (Stop && !Queued)
+      return;
+  }
+}
+
+#endif // LLVM_ENABLE_THREADS
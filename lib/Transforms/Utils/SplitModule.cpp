@@ -92,18 +92,10 @@ static void addAllGlobalValueUsers(ClusterMapType &GVtoClusterMap,
   }
 }
 
-// Find partitions for module in the way that no locals need to be
-// globalized.
-// Try to balance pack those partitions into N files since this roughly equals
-// thread balancing for the backend codegen step.
-static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
-                           unsigned N) {
-  // At this point module should have the proper mix of globals and locals.
-  // As we attempt to partition this module, we must not change any
-  // locals to globals.
-  LLVM_DEBUG(dbgs() << "Partition module with (" << M->size()
-                    << ")functions\n");
-  ClusterMapType GVtoClusterMap;
+// Put globals that must not end up in different partitions into the same
+// cluster: members of a comdat, aliases and their aliasees, functions and the
+// users of their block addresses, and locals and their users.
+static void buildClusters(Module *M, ClusterMapType &GVtoClusterMap) {
   ComdatMembersType ComdatMembers;
 
   auto recordGVSet = [&GVtoClusterMap, &ComdatMembers](GlobalValue &GV) {
@@ -148,6 +140,21 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
   llvm::for_each(M->functions(), recordGVSet);
   llvm::for_each(M->globals(), recordGVSet);
   llvm::for_each(M->aliases(), recordGVSet);
+}
+
+// Find partitions for module in the way that no locals need to be
+// globalized.
+// Try to balance pack those partitions into N files since this roughly equals
+// thread balancing for the backend codegen step.
+static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
+                           unsigned N) {
+  // At this point module should have the proper mix of globals and locals.
+  // As we attempt to partition this module, we must not change any
+  // locals to globals.
+  LLVM_DEBUG(dbgs() << "Partition module with (" << M->size()
+                    << ")functions\n");
+  ClusterMapType GVtoClusterMap;
+  buildClusters(M, GVtoClusterMap);
 
   // Assigned all GVs to merged clusters while balancing number of objects in
   // each.
@@ -215,6 +222,57 @@ static void findPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
   }
 }
 
+// Find partitions for module that are contiguous runs of the module's
+// definitions, so that concatenating the partitions in order yields the
+// original function and global layout. Globals that must stay together are
+// placed in the partition of the first one of them. The partitions are
+// balanced by instruction count, as a proxy for backend codegen time.
+static void findOrderedPartitions(Module *M, ClusterIDMapType &ClusterIDMap,
+                                  unsigned N) {
+  LLVM_DEBUG(dbgs() << "Ordered partition module with (" << M->size()
+                    << ")functions\n");
+  ClusterMapType GVtoClusterMap;
+  buildClusters(M, GVtoClusterMap);
+
+  SmallVector<std::pair<const GlobalValue *, uint64_t>, 64> Defs;
+  uint64_t TotalWeight = 0;
+  auto recordWeight = [&](const GlobalValue &GV) {
+    if (GV.isDeclaration())
+      return;
+    uint64_t Weight = 1;
+    if (const Function *F = dyn_cast<Function>(&GV))
+      for (const BasicBlock &BB : *F)
+        Weight += BB.size();
+    Defs.push_back(std::make_pair(&GV, Weight));
+    TotalWeight += Weight;
+  };
+  llvm::for_each(M->functions(), recordWeight);
+  llvm::for_each(M->globals(), recordWeight);
+  llvm::for_each(M->aliases(), recordWeight);
+
+  DenseMap<const GlobalValue *, unsigned> LeaderIDMap;
+  unsigned CurrentClusterID = 0;
+  uint64_t Filled = 0;
+  for (auto &Def : Defs) {
+    const GlobalValue *GV = Def.first;
+    const GlobalValue *Leader = GV;
+    if (GVtoClusterMap.findValue(GV) != GVtoClusterMap.end())
+      Leader = GVtoClusterMap.getLeaderValue(GV);
+
+    // Move on to the next partition once this one got its share, counting
+    // half of the current definition's weight to round to the nearest split.
+    if (CurrentClusterID + 1 < N &&
+        Filled + Def.second / 2 >= TotalWeight * (CurrentClusterID + 1) / N)
+      ++CurrentClusterID;
+    Filled += Def.second;
+
+    auto Inserted = LeaderIDMap.insert(std::make_pair(Leader, CurrentClusterID));
+    ClusterIDMap[GV] = Inserted.first->second;
+    LLVM_DEBUG(dbgs() << "Root[" << ClusterIDMap[GV] << "] ----> "
+                      << GV->getName() << "\n");
+  }
+}
+
 static void externalize(GlobalValue *GV) {
   if (GV->hasLocalLinkage()) {
     GV->setLinkage(GlobalValue::ExternalLinkage);
@@ -252,7 +310,7 @@ static bool isInPartition(const GlobalValue *GV, unsigned I, unsigned N) {
 void llvm::SplitModule(
     std::unique_ptr<Module> M, unsigned N,
     function_ref<void(std::unique_ptr<Module> MPart)> ModuleCallback,
-    bool PreserveLocals) {
+    bool PreserveLocals, bool PreserveOrder) {
   if (!PreserveLocals) {
     for (Function &F : *M)
       externalize(&F);
@@ -267,7 +325,10 @@ void llvm::SplitModule(
   // This performs splitting without a need for externalization, which might not
   // always be possible.
   ClusterIDMapType ClusterIDMap;
-  findPartitions(M.get(), ClusterIDMap, N);
+  if (PreserveOrder)
+    findOrderedPartitions(M.get(), ClusterIDMap, N);
+  else
+    findPartitions(M.get(), ClusterIDMap, N);
 
   // FIXME: We should be able to reuse M as the last partition instead of
   // cloning it.
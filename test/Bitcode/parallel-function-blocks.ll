@@ -0,0 +1,54 @@
+; Check that encoding function blocks on several threads produces the same
+; bitcode as the serial writer, including the VST function offsets.
+; RUN: llvm-as %s -o %t.bc
+; RUN: llvm-as -bitcode-write-threads=4 %s -o %t.parallel.bc
+; RUN: cmp %t.bc %t.parallel.bc
+; RUN: llvm-dis %t.parallel.bc -o - | FileCheck %s
+
+; Function bodies are located through the VST offsets when loading lazily.
+; RUN: llvm-extract -func=g %t.parallel.bc -S | FileCheck %s --check-prefix=G
+
+@p = global i8* blockaddress(@f, %bb)
+
+; CHECK-LABEL: define i32 @f(i32 %a)
+; CHECK: %x = add i32 %a, 42, !md ![[LOCAL:[0-9]+]]
+define i32 @f(i32 %a) {
+entry:
+  %x = add i32 %a, 42, !md !0
+  br label %bb
+bb:
+  ret i32 %x
+}
+
+; CHECK-LABEL: define i32 @g(i32 %a)
+; CHECK: call i32 @f(i32 %a), !dbg
+; G: declare i32 @f(i32)
+; G-LABEL: define i32 @g(i32 %a)
+; G: call i32 @f(i32 %a), !dbg
+define i32 @g(i32 %a) !dbg !6 {
+  %r = call i32 @f(i32 %a), !dbg !9
+  ret i32 %r, !dbg !9
+}
+
+; CHECK-LABEL: define float @h(float %a)
+; CHECK: fadd fast float %a, 1.500000e+00
+define float @h(float %a) {
+  %r = fadd fast float %a, 1.5
+  ret float %r
+}
+
+; CHECK: ![[LOCAL]] = !{!"local to f"}
+!0 = !{!"local to f"}
+
+!llvm.dbg.cu = !{!1}
+!llvm.module.flags = !{!4, !5}
+
+!1 = distinct !DICompileUnit(language: DW_LANG_C99, file: !2, emissionKind: FullDebug, enums: !3)
+!2 = !DIFile(filename: "t.c", directory: "/")
+!3 = !{}
+!4 = !{i32 2, !"Dwarf Version", i32 4}
+!5 = !{i32 2, !"Debug Info Version", i32 3}
+!6 = distinct !DISubprogram(name: "g", scope: !2, file: !2, line: 1, type: !7, isLocal: false, isDefinition: true, unit: !1)
+!7 = !DISubroutineType(types: !8)
+!8 = !{null}
+!9 = !DILocation(line: 2, column: 3, scope: !6)
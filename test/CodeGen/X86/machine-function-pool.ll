@@ -0,0 +1,34 @@
+; REQUIRES: asserts
+; RUN: llc < %s -mtriple=x86_64-- -stats -o /dev/null 2>&1 | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-- -stats -machine-function-pool-limit=0 \
+; RUN:   -o /dev/null 2>&1 | FileCheck %s --check-prefix=NOPOOL
+
+; Each function fits in one slab of its allocator. The second and third
+; functions reuse the slab and the MachineRegisterInfo of the one before.
+
+; CHECK: codegen               - Maximum bytes of slabs held by the allocator of a function
+; CHECK: codegen               - Maximum bytes allocated by the allocator of a function
+; CHECK: 4096 machine-function-pool - Maximum bytes of slabs held by the pool
+; CHECK:    2 machine-function-pool - Number of MachineRegisterInfos reused
+; CHECK:    1 machine-function-pool - Number of allocator slabs allocated
+; CHECK:    2 machine-function-pool - Number of allocator slabs reused
+
+; NOPOOL-NOT: machine-function-pool - Maximum bytes of slabs held by the pool
+; NOPOOL-NOT: Number of MachineRegisterInfos reused
+; NOPOOL:    3 machine-function-pool - Number of allocator slabs allocated
+; NOPOOL-NOT: Number of allocator slabs reused
+
+define i32 @f1(i32 %a) {
+  %b = add i32 %a, 1
+  ret i32 %b
+}
+
+define i32 @f2(i32 %a) {
+  %b = mul i32 %a, 3
+  ret i32 %b
+}
+
+define i32 @f3(i32 %a) {
+  %b = sub i32 %a, 7
+  ret i32 %b
+}
@@ -42,6 +42,10 @@
 ; YAML-NEXT:   - String:          ' due to a function attribute or command-line switch'
 ; YAML-NEXT: ...
 
+; RUN: llc %s -mtriple=x86_64-unknown-unknown -o /dev/null -pass-remarks-output=%t.bin -pass-remarks-format=binary
+; RUN: llvm-remarkutil convert %t.bin -o %t.bin.yaml
+; RUN: diff %t.yaml %t.bin.yaml
+
 define void @nossp() ssp {
   ret void
 }
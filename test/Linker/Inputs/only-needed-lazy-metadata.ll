@@ -0,0 +1,27 @@
+define void @foo(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !1
+  ret void
+}
+
+define void @foo2(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !1
+  ret void
+}
+
+define void @bar(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !3
+  ret void
+}
+
+define void @baz(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !3
+  ret void
+}
+
+!1 = !{!2}
+!2 = !{!"foo"}
+!3 = !{!4, !5, !6, !7}
+!4 = !{!"bar"}
+!5 = !{!"bar2"}
+!6 = !{!"bar3"}
+!7 = !{!3}
@@ -0,0 +1,32 @@
+; RUN: llvm-as %s -o %t.bc
+; RUN: llvm-as -bitcode-mdindex-threshold=0 \
+; RUN:   %S/Inputs/only-needed-lazy-metadata.ll -o %t2.bc
+; RUN: llvm-link -S -only-needed %t.bc %t2.bc | FileCheck %s
+
+; With -only-needed, only the global metadata referenced from @foo should be
+; loaded from the second module.
+; RUN: llvm-link -only-needed %t.bc %t2.bc -o /dev/null -stats 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=LAZY
+; RUN: llvm-link -only-needed %t.bc %t2.bc -o /dev/null -stats \
+; RUN:   -disable-ondemand-mds-loading 2>&1 | FileCheck %s --check-prefix=NOTLAZY
+; REQUIRES: asserts
+
+; CHECK: define void @main()
+; CHECK: define void @foo(i32 %arg) {
+; CHECK-NEXT: %tmp = add i32 %arg, 0, !md ![[FOO:[0-9]+]]
+; CHECK-NOT: define
+; CHECK: ![[FOO]] = !{![[STR:[0-9]+]]}
+; CHECK: ![[STR]] = !{!"foo"}
+; CHECK-NOT: !"bar"
+
+; LAZY: 56 bitcode-reader - Number of Metadata records loaded
+; LAZY: 1 bitcode-reader - Number of MDStrings loaded
+; NOTLAZY: 62 bitcode-reader - Number of Metadata records loaded
+; NOTLAZY: 4 bitcode-reader - Number of MDStrings loaded
+
+define void @main() {
+  call void @foo(i32 0)
+  ret void
+}
+
+declare void @foo(i32)
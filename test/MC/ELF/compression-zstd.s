@@ -0,0 +1,46 @@
+// Check zstd style
+// RUN: llvm-mc -filetype=obj -compress-debug-sections=zstd -triple x86_64-pc-linux-gnu < %s -o %t
+// RUN: llvm-objdump -s %t | FileCheck --check-prefix=CHECK-ZSTD-STYLE %s
+// RUN: llvm-dwarfdump -debug-str %t | FileCheck --check-prefix=STR %s
+// RUN: llvm-readobj -sections %t | FileCheck --check-prefix=ZSTD-STYLE-FLAGS %s
+
+// REQUIRES: zstd
+
+// Don't compress small sections, such as this simple debug_abbrev example
+// CHECK-ZSTD-STYLE: Contents of section .debug_abbrev:
+// CHECK-ZSTD-STYLE-NEXT: 0000 0111001b 0e000000
+
+// The compression header starts with ch_type ELFCOMPRESS_ZSTD.
+// CHECK-ZSTD-STYLE: Contents of section .debug_str:
+// CHECK-ZSTD-STYLE-NEXT: 0000 02000000 00000000
+
+// STR: perfectly compressable data sample *****************************************
+
+// ZSTD-STYLE-FLAGS:      Section {
+// ZSTD-STYLE-FLAGS:        Index:
+// ZSTD-STYLE-FLAGS:        Name: .debug_str
+// ZSTD-STYLE-FLAGS-NEXT:   Type: SHT_PROGBITS
+// ZSTD-STYLE-FLAGS-NEXT:   Flags [
+// ZSTD-STYLE-FLAGS-NEXT:     SHF_COMPRESSED
+
+	.section	.debug_abbrev,"",@progbits
+.Lsection_abbrev:
+	.byte	1                       # Abbreviation Code
+	.byte	17                      # DW_TAG_compile_unit
+	.byte	0                       # DW_CHILDREN_no
+	.byte	27                      # DW_AT_comp_dir
+	.byte	14                      # DW_FORM_strp
+	.byte	0                       # EOM(1)
+	.byte	0                       # EOM(2)
+
+	.section	.debug_info,"",@progbits
+	.long	12                      # Length of Unit
+	.short	4                       # DWARF version number
+	.long	.Lsection_abbrev        # Offset Into Abbrev. Section
+	.byte	8                       # Address Size (in bytes)
+	.byte	1                       # Abbrev [1] DW_TAG_compile_unit
+	.long	.Linfo_string0          # DW_AT_comp_dir
+
+	.section        .debug_str,"MS",@progbits,1
+.Linfo_string0:
+        .asciz  "perfectly compressable data sample *****************************************"
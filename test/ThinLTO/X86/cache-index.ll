@@ -0,0 +1,65 @@
+; Check the indexed ThinLTO cache of llvm-lto2: lookups go through
+; llvmcache.index, and hits, misses and evictions are recorded there.
+
+; RUN: opt -module-hash -module-summary %s -o %t.bc
+; RUN: opt -module-hash -module-summary %p/Inputs/cache.ll -o %t2.bc
+
+; The first link populates the cache.
+; RUN: rm -Rf %t.cache
+; RUN: llvm-lto2 run -o %t.o %t2.bc %t.bc -cache-dir %t.cache -cache-index \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx
+; RUN: ls %t.cache/llvmcache.index
+; RUN: ls %t.cache/llvmcache-* | count 2
+; RUN: llvm-lto2 cache-stats %t.cache | FileCheck %s --check-prefix=MISS
+; MISS: entries: 2
+; MISS: hits: 0
+; MISS-NEXT: misses: 2
+; MISS-NEXT: hit rate: 0.0%
+; MISS-NEXT: evictions: 0
+
+; The second one hits.
+; RUN: llvm-lto2 run -o %t.o %t2.bc %t.bc -cache-dir %t.cache -cache-index \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx
+; RUN: llvm-lto2 cache-stats %t.cache | FileCheck %s --check-prefix=HIT
+; HIT: entries: 2
+; HIT: hits: 2
+; HIT-NEXT: misses: 2
+; HIT-NEXT: hit rate: 50.0%
+; HIT-NEXT: evictions: 0
+
+; Offline pruning evicts entries down to the policy.
+; RUN: llvm-lto2 cache-prune %t.cache cache_size_files=1:cache_size=0% \
+; RUN:   | FileCheck %s --check-prefix=PRUNE
+; PRUNE: removed: 1
+; RUN: ls %t.cache/llvmcache-* | count 1
+; RUN: llvm-lto2 cache-stats %t.cache | FileCheck %s --check-prefix=PRUNED
+; PRUNED: entries: 1
+; PRUNED: evictions: 1
+
+; A link with a policy prunes after adding each entry.
+; RUN: rm -Rf %t.cache
+; RUN: llvm-lto2 run -o %t.o %t2.bc %t.bc -cache-dir %t.cache -cache-index \
+; RUN:  -cache-policy=cache_size_files=1 \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx
+; RUN: ls %t.cache/llvmcache-* | count 1
+; RUN: llvm-lto2 cache-stats %t.cache | FileCheck %s --check-prefix=POLICY
+; POLICY: entries: 1
+; POLICY: evictions: 1
+
+; RUN: not llvm-lto2 cache-prune %t.cache bogus 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=BADPOLICY
+; BADPOLICY: llvm-lto2: invalid cache policy: Unknown key: 'bogus'
+
+target datalayout = "e-m:o-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-apple-macosx10.11.0"
+
+define void @globalfunc() #0 {
+entry:
+  ret void
+}
@@ -0,0 +1,71 @@
+; REQUIRES: asserts
+; Check that an incremental link reuses the summaries of unchanged modules
+; from the index saved by the previous link.
+
+; RUN: opt -module-hash -module-summary %s -o %t.bc
+; RUN: opt -module-hash -module-summary %p/Inputs/cache.ll -o %t2.bc
+; RUN: rm -f %t.index
+
+; The first link reads every summary and saves the index.
+; RUN: llvm-lto2 run -o %t1.o %t2.bc %t.bc -incremental-index=%t.index \
+; RUN:  -stats -stats-file=%t1.stats -save-temps \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx \
+; RUN:  -r=%t.bc,_g,plx
+; RUN: FileCheck %s --check-prefix=FIRST < %t1.stats
+; FIRST: "lto.NumSummariesRead": 2
+; FIRST-NOT: NumSummariesReused
+; RUN: llvm-bcanalyzer -dump %t.index | FileCheck %s --check-prefix=INDEX
+; INDEX: <MODULE_STRTAB_BLOCK
+; INDEX-COUNT-2: <ENTRY {{.*}} record string =
+; INDEX: <GLOBALVAL_SUMMARY_BLOCK
+
+; The second link reuses both, and produces the same code.
+; RUN: llvm-lto2 run -o %t2.o %t2.bc %t.bc -incremental-index=%t.index \
+; RUN:  -stats -stats-file=%t2.stats -save-temps \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx \
+; RUN:  -r=%t.bc,_g,plx
+; RUN: FileCheck %s --check-prefix=REUSE < %t2.stats
+; REUSE-NOT: NumSummariesRead
+; REUSE: "lto.NumSummariesReused": 2
+; RUN: cmp %t1.o.1 %t2.o.1
+; RUN: cmp %t1.o.2 %t2.o.2
+; RUN: cmp %t1.o.1.3.import.bc %t2.o.1.3.import.bc
+
+; A module with a different hash is read again.
+; RUN: sed -e 's/i32 0/i32 1/' %s | opt -module-hash -module-summary -o %t.bc
+; RUN: llvm-lto2 run -o %t3.o %t2.bc %t.bc -incremental-index=%t.index \
+; RUN:  -stats -stats-file=%t3.stats \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,lx \
+; RUN:  -r=%t.bc,_globalfunc,plx \
+; RUN:  -r=%t.bc,_g,plx
+; RUN: FileCheck %s --check-prefix=CHANGED < %t3.stats
+; CHANGED: "lto.NumSummariesRead": 1
+; CHANGED: "lto.NumSummariesReused": 1
+
+; A module that is no longer part of the link is dropped from the index.
+; RUN: llvm-lto2 run -o %t4.o %t2.bc -incremental-index=%t.index \
+; RUN:  -stats -stats-file=%t4.stats \
+; RUN:  -r=%t2.bc,_main,plx \
+; RUN:  -r=%t2.bc,_globalfunc,
+; RUN: FileCheck %s --check-prefix=DROPPED < %t4.stats
+; DROPPED: "lto.NumSummariesDropped": 1
+; DROPPED: "lto.NumSummariesReused": 1
+; RUN: llvm-bcanalyzer -dump %t.index | FileCheck %s --check-prefix=INDEX1
+; INDEX1: <MODULE_STRTAB_BLOCK
+; INDEX1-NEXT: <ENTRY {{.*}} record string = '{{.*}}2.bc'
+; INDEX1-NOT: <ENTRY
+
+target datalayout = "e-m:o-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-apple-macosx10.11.0"
+
+@g = global i32 0
+
+define void @globalfunc() {
+entry:
+  ret void
+}
@@ -1,5 +1,6 @@
-; RUN: llc -O0 %s -o - -filetype=obj \
-; RUN:   | llvm-dwarfdump -statistics - | FileCheck %s
+; RUN: llc -O0 %s -o %t.o -filetype=obj
+; RUN: llvm-dwarfdump -statistics %t.o | FileCheck %s
+; RUN: llvm-dwarfdump -statistics -j 2 %t.o | FileCheck %s
 
 ; int GlobalConst = 42;
 ; int Global;
@@ -1,6 +1,7 @@
-# RUN: llvm-mc %s -filetype obj -triple x86_64-apple-darwin -o - \
-# RUN: | not llvm-dwarfdump -v -verify - \
-# RUN: | FileCheck %s
+# RUN: llvm-mc %s -filetype obj -triple x86_64-apple-darwin -o %t.o
+# RUN: not llvm-dwarfdump -v -verify %t.o | FileCheck %s
+# RUN: not llvm-dwarfdump -v -verify -j 4 %t.o > %t.j4
+# RUN: not llvm-dwarfdump -v -verify %t.o | diff - %t.j4
 
 # CHECK: error: DIE has invalid DW_AT_stmt_list encoding:{{[[:space:]]}}
 # CHECK-NEXT: 0x0000000c: DW_TAG_compile_unit [1] *
@@ -0,0 +1,51 @@
+; RUN: llvm-as -bitcode-mdindex-threshold=0 %s -o %t.bc
+; RUN: llvm-extract -func=foo %t.bc -S | FileCheck %s
+
+; Check that extracting @foo only loads the global metadata it references,
+; and not the metadata only used by @bar and @baz.
+; RUN: llvm-extract -func=foo %t.bc -o /dev/null -stats 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=LAZY
+; RUN: llvm-extract -func=foo %t.bc -o /dev/null -stats \
+; RUN:   -disable-ondemand-mds-loading 2>&1 | FileCheck %s --check-prefix=NOTLAZY
+; REQUIRES: asserts
+
+; CHECK: define void @foo(i32 %arg) {
+; CHECK-NEXT: %tmp = add i32 %arg, 0, !md ![[FOO:[0-9]+]]
+; CHECK: ![[FOO]] = !{![[STR:[0-9]+]]}
+; CHECK: ![[STR]] = !{!"foo"}
+; CHECK-NOT: !"bar"
+
+; LAZY: 31 bitcode-reader - Number of Metadata records loaded
+; LAZY: 1 bitcode-reader - Number of MDStrings loaded
+; NOTLAZY: 37 bitcode-reader - Number of Metadata records loaded
+; NOTLAZY: 4 bitcode-reader - Number of MDStrings loaded
+
+define void @foo(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !1
+  ret void
+}
+
+define void @foo2(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !1
+  ret void
+}
+
+; Both functions below reference the same metadata, so that it is emitted in
+; the global metadata block rather than in a function block.
+define void @bar(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !3
+  ret void
+}
+
+define void @baz(i32 %arg) {
+  %tmp = add i32 %arg, 0, !md !3
+  ret void
+}
+
+!1 = !{!2}
+!2 = !{!"foo"}
+!3 = !{!4, !5, !6, !7}
+!4 = !{!"bar"}
+!5 = !{!"bar2"}
+!6 = !{!"bar3"}
+!7 = !{!3}
@@ -0,0 +1,44 @@
+; RUN: llvm-split -j2 -preserve-locals -preserve-order -o %t %s
+; RUN: llvm-dis -o - %t0 | FileCheck --check-prefix=CHECK0 %s
+; RUN: llvm-dis -o - %t1 | FileCheck --check-prefix=CHECK1 %s
+
+; Each partition is a contiguous run of the module's functions, except that
+; local_func stays with its first user.
+; CHECK0: define i32 @first
+; CHECK0: define i32 @second
+; CHECK0: declare i32 @third
+; CHECK0: declare i32 @fourth
+; CHECK0: define internal i32 @local_func
+
+; CHECK1: declare i32 @first
+; CHECK1: declare i32 @second
+; CHECK1: define i32 @third
+; CHECK1: define i32 @fourth
+; CHECK1: declare dso_local i32 @local_func
+
+define i32 @first(i32 %x) {
+  %a = add i32 %x, 1
+  %b = call i32 @local_func(i32 %a)
+  ret i32 %b
+}
+
+define i32 @second(i32 %x) {
+  %a = add i32 %x, 2
+  ret i32 %a
+}
+
+define i32 @third(i32 %x) {
+  %a = add i32 %x, 3
+  %b = add i32 %a, 3
+  ret i32 %b
+}
+
+define i32 @fourth(i32 %x) {
+  %a = add i32 %x, 4
+  %b = add i32 %a, 4
+  ret i32 %b
+}
+
+define internal i32 @local_func(i32 %x) {
+  ret i32 %x
+}
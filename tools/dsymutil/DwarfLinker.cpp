@@ -90,6 +90,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <future>
 #include <limits>
 #include <map>
 #include <memory>
@@ -1454,6 +1455,22 @@ struct DebugMapObjectRange {
 using RangesTy = std::map<uint64_t, DebugMapObjectRange>;
 using UnitListTy = std::vector<std::unique_ptr<CompileUnit>>;
 
+/// The line table of a unit with its rows relocated to the linked addresses.
+struct RelocatedLineTable {
+  /// The DW_AT_stmt_list of the unit. Nothing is emitted when it has none.
+  Optional<uint64_t> StmtList;
+  DWARFDebugLine::Prologue Prologue;
+  std::vector<DWARFDebugLine::Row> Rows;
+  /// The warnings parsing the original line table gave, in order.
+  std::vector<std::string> Warnings;
+};
+
+/// A RelocatedLineTable computed on a worker thread.
+struct PendingLineTable {
+  std::shared_future<void> Ready;
+  RelocatedLineTable Table;
+};
+
 /// The core of the Dwarf linking logic.
 ///
 /// The link of the dwarf information from the object files will be
@@ -1700,9 +1717,14 @@ private:
     /// Construct the output DIE tree by cloning the DIEs we
     /// chose to keep above. If there are no valid relocs, then there's
     /// nothing to clone/emit.
+    ///
+    /// \p LineTables, if not empty, holds the line tables of the units
+    /// being relocated by worker threads, in the order of the units.
     void cloneAllCompileUnits(DWARFContext &DwarfContext,
                               const DebugMapObject &DMO, RangesTy &Ranges,
-                              OffsetsStringPool &StringPool);
+                              OffsetsStringPool &StringPool,
+                              MutableArrayRef<PendingLineTable> LineTables =
+                                  None);
 
   private:
     using AttributeSpec = DWARFAbbreviationDeclaration::AttributeSpec;
@@ -1820,9 +1842,11 @@ private:
 
   /// Extract the line tables from the original dwarf, extract the relevant
   /// parts according to the linked function ranges and emit the result in the
-  /// debug_line section.
+  /// debug_line section. If \p Pending is set, the relocated table is taken
+  /// from it once its worker thread is done instead of being computed here.
   void patchLineTableForUnit(CompileUnit &Unit, DWARFContext &OrigDwarf,
-                             RangesTy &Ranges, const DebugMapObject &DMO);
+                             RangesTy &Ranges, const DebugMapObject &DMO,
+                             PendingLineTable *Pending = nullptr);
 
   /// Emit the accelerator entries for \p Unit.
   void emitAcceleratorEntriesForUnit(CompileUnit &Unit);
@@ -3583,34 +3607,38 @@ static void patchStmtList(DIE &Die, DIEInteger Offset) {
 }
 
 /// Extract the line table for \p Unit from \p OrigDwarf, and
-/// recreate a relocated version of these for the address ranges that
-/// are present in the binary.
-void DwarfLinker::patchLineTableForUnit(CompileUnit &Unit,
-                                        DWARFContext &OrigDwarf,
-                                        RangesTy &Ranges,
-                                        const DebugMapObject &DMO) {
+/// recreate a relocated version of it for the address ranges that
+/// are present in the binary. This only reads the keep information of
+/// \p Unit and the input, so it can run on a worker thread while the
+/// units are being cloned.
+static RelocatedLineTable relocateLineTable(const CompileUnit &Unit,
+                                            const DWARFContext &OrigDwarf,
+                                            const RangesTy &Ranges) {
+  RelocatedLineTable Result;
   DWARFDie CUDie = Unit.getOrigUnit().getUnitDIE();
   auto StmtList = dwarf::toSectionOffset(CUDie.find(dwarf::DW_AT_stmt_list));
   if (!StmtList)
-    return;
+    return Result;
+  Result.StmtList = StmtList;
 
-  // Update the cloned DW_AT_stmt_list with the correct debug_line offset.
-  if (auto *OutputDIE = Unit.getOutputUnitDIE())
-    patchStmtList(*OutputDIE, DIEInteger(Streamer->getLineSectionSize()));
-
-  // Parse the original line info for the unit.
+  // Parse the original line info for the unit. The warnings are collected
+  // rather than printed so that they come out in unit order.
   DWARFDebugLine::LineTable LineTable;
   uint32_t StmtOffset = *StmtList;
   DWARFDataExtractor LineExtractor(
       OrigDwarf.getDWARFObj(), OrigDwarf.getDWARFObj().getLineSection(),
       OrigDwarf.isLittleEndian(), Unit.getOrigUnit().getAddressByteSize());
 
-  Error Err = LineTable.parse(LineExtractor, &StmtOffset, OrigDwarf,
-                              &Unit.getOrigUnit());
-  DWARFDebugLine::warn(std::move(Err));
+  auto AddWarnings = [&](Error Err) {
+    handleAllErrors(std::move(Err), [&](ErrorInfoBase &Info) {
+      Result.Warnings.push_back(Info.message());
+    });
+  };
+  AddWarnings(LineTable.parse(LineExtractor, &StmtOffset, OrigDwarf,
+                              &Unit.getOrigUnit(), AddWarnings));
 
   // This vector is the output line table.
-  std::vector<DWARFDebugLine::Row> NewRows;
+  std::vector<DWARFDebugLine::Row> &NewRows = Result.Rows;
   NewRows.reserve(LineTable.Rows.size());
 
   // Current sequence of rows being extracted, before being inserted
@@ -3695,30 +3723,58 @@ void DwarfLinker::patchLineTableForUnit(CompileUnit &Unit,
       insertLineSequence(Seq, NewRows);
   }
 
+  Result.Prologue = std::move(LineTable.Prologue);
+  return Result;
+}
+
+void DwarfLinker::patchLineTableForUnit(CompileUnit &Unit,
+                                        DWARFContext &OrigDwarf,
+                                        RangesTy &Ranges,
+                                        const DebugMapObject &DMO,
+                                        PendingLineTable *Pending) {
+  RelocatedLineTable LineTable;
+  if (Pending) {
+    Pending->Ready.wait();
+    LineTable = std::move(Pending->Table);
+  } else {
+    LineTable = relocateLineTable(Unit, OrigDwarf, Ranges);
+  }
+  if (!LineTable.StmtList)
+    return;
+  uint64_t StmtList = *LineTable.StmtList;
+
+  // Update the cloned DW_AT_stmt_list with the correct debug_line offset.
+  if (auto *OutputDIE = Unit.getOutputUnitDIE())
+    patchStmtList(*OutputDIE, DIEInteger(Streamer->getLineSectionSize()));
+
+  for (const std::string &Warning : LineTable.Warnings)
+    DWARFDebugLine::warn(
+        make_error<StringError>(Warning, inconvertibleErrorCode()));
+
   // Finished extracting, now emit the line tables.
   // FIXME: LLVM hard-codes its prologue values. We just copy the
   // prologue over and that works because we act as both producer and
   // consumer. It would be nicer to have a real configurable line
   // table emitter.
-  if (LineTable.Prologue.getVersion() < 2 ||
-      LineTable.Prologue.getVersion() > 5 ||
-      LineTable.Prologue.DefaultIsStmt != DWARF2_LINE_DEFAULT_IS_STMT ||
-      LineTable.Prologue.OpcodeBase > 13)
+  const DWARFDebugLine::Prologue &Prologue = LineTable.Prologue;
+  if (Prologue.getVersion() < 2 || Prologue.getVersion() > 5 ||
+      Prologue.DefaultIsStmt != DWARF2_LINE_DEFAULT_IS_STMT ||
+      Prologue.OpcodeBase > 13)
     reportWarning("line table parameters mismatch. Cannot emit.", DMO);
   else {
-    uint32_t PrologueEnd = *StmtList + 10 + LineTable.Prologue.PrologueLength;
+    uint32_t PrologueEnd = StmtList + 10 + Prologue.PrologueLength;
     // DWARF v5 has an extra 2 bytes of information before the header_length
     // field.
-    if (LineTable.Prologue.getVersion() == 5)
+    if (Prologue.getVersion() == 5)
       PrologueEnd += 2;
     StringRef LineData = OrigDwarf.getDWARFObj().getLineSection().Data;
     MCDwarfLineTableParams Params;
-    Params.DWARF2LineOpcodeBase = LineTable.Prologue.OpcodeBase;
-    Params.DWARF2LineBase = LineTable.Prologue.LineBase;
-    Params.DWARF2LineRange = LineTable.Prologue.LineRange;
+    Params.DWARF2LineOpcodeBase = Prologue.OpcodeBase;
+    Params.DWARF2LineBase = Prologue.LineBase;
+    Params.DWARF2LineRange = Prologue.LineRange;
     Streamer->emitLineTableForUnit(Params,
-                                   LineData.slice(*StmtList + 4, PrologueEnd),
-                                   LineTable.Prologue.MinInstLength, NewRows,
+                                   LineData.slice(StmtList + 4, PrologueEnd),
+                                   Prologue.MinInstLength, LineTable.Rows,
                                    Unit.getOrigUnit().getAddressByteSize());
   }
 }
@@ -4092,11 +4148,15 @@ Error DwarfLinker::loadClangModule(StringRef Filename, StringRef ModulePath,
 
 void DwarfLinker::DIECloner::cloneAllCompileUnits(
     DWARFContext &DwarfContext, const DebugMapObject &DMO, RangesTy &Ranges,
-    OffsetsStringPool &StringPool) {
+    OffsetsStringPool &StringPool,
+    MutableArrayRef<PendingLineTable> LineTables) {
   if (!Linker.Streamer)
     return;
 
-  for (auto &CurrentUnit : CompileUnits) {
+  assert((LineTables.empty() || LineTables.size() == CompileUnits.size()) &&
+         "one line table per unit");
+  for (unsigned I = 0, E = CompileUnits.size(); I != E; ++I) {
+    auto &CurrentUnit = CompileUnits[I];
     auto InputDIE = CurrentUnit->getOrigUnit().getUnitDIE();
     CurrentUnit->setStartOffset(Linker.OutputDebugInfoSize);
     if (!InputDIE) {
@@ -4118,7 +4178,9 @@ void DwarfLinker::DIECloner::cloneAllCompileUnits(
       // FIXME: for compatibility with the classic dsymutil, we emit an empty
       // line table for the unit, even if the unit doesn't actually exist in
       // the DIE tree.
-      Linker.patchLineTableForUnit(*CurrentUnit, DwarfContext, Ranges, DMO);
+      Linker.patchLineTableForUnit(*CurrentUnit, DwarfContext, Ranges, DMO,
+                                   LineTables.empty() ? nullptr
+                                                      : &LineTables[I]);
       Linker.emitAcceleratorEntriesForUnit(*CurrentUnit);
       Linker.patchRangesForUnit(*CurrentUnit, DwarfContext, DMO);
       Linker.Streamer->emitLocationsForUnit(*CurrentUnit, DwarfContext);
@@ -4230,7 +4292,28 @@ bool DwarfLinker::link(const DebugMap &Map) {
   // ODR Contexts for the link.
   DeclContextTree ODRContexts;
 
-  for (LinkContext &LinkContext : ObjectContexts) {
+  // With several threads, the work that only depends on one object is done
+  // on a pool of workers: reading in the debug info of each object ahead of
+  // the loop below, and relocating the line tables of an object while its
+  // DIEs are being cloned. The results are consumed in object and unit
+  // order, so the output does not depend on the number of threads.
+  std::unique_ptr<ThreadPool> Workers;
+  std::vector<std::shared_future<void>> ExtractedObjects(NumObjects);
+  if (Options.Threads > 1) {
+    Workers = llvm::make_unique<ThreadPool>(Options.Threads);
+    for (unsigned I = 0; I != NumObjects; ++I) {
+      DWARFContext *DwarfContext = ObjectContexts[I].DwarfContext.get();
+      if (!DwarfContext || LLVM_UNLIKELY(Options.Update))
+        continue;
+      ExtractedObjects[I] = Workers->async([DwarfContext]() {
+        for (const auto &CU : DwarfContext->compile_units())
+          CU->getUnitDIE(false);
+      });
+    }
+  }
+
+  for (unsigned I = 0; I != NumObjects; ++I) {
+    LinkContext &LinkContext = ObjectContexts[I];
     if (Options.Verbose)
       outs() << "DEBUG MAP OBJECT: " << LinkContext.DMO.getObjectFilename()
              << "\n";
@@ -4291,6 +4374,8 @@ bool DwarfLinker::link(const DebugMap &Map) {
       continue;
 
     startDebugObject(LinkContext);
+    if (ExtractedObjects[I].valid())
+      ExtractedObjects[I].wait();
 
     // In a first phase, just read in the debug info and load all clang modules.
     LinkContext.CompileUnits.reserve(
@@ -4394,12 +4479,35 @@ bool DwarfLinker::link(const DebugMap &Map) {
       // array again (in the same way findValidRelocsInDebugInfo() did). We
       // need to reset the NextValidReloc index to the beginning.
       LinkContext.RelocMgr.resetValidRelocs();
-      if (LinkContext.RelocMgr.hasValidRelocs() ||
-          LLVM_UNLIKELY(Options.Update))
+      bool HasValidRelocs = LinkContext.RelocMgr.hasValidRelocs();
+
+      // Now that the function ranges of the units are known, relocate their
+      // line tables on the workers. They are emitted in order by
+      // cloneAllCompileUnits().
+      std::vector<PendingLineTable> LineTables;
+      if (Workers && HasValidRelocs && !Options.NoOutput &&
+          LLVM_LIKELY(!Options.Update)) {
+        LineTables.resize(LinkContext.CompileUnits.size());
+        for (unsigned I = 0, E = LineTables.size(); I != E; ++I) {
+          const CompileUnit *Unit = LinkContext.CompileUnits[I].get();
+          PendingLineTable *LineTable = &LineTables[I];
+          LineTable->Ready = Workers->async([Unit, LineTable, &LinkContext]() {
+            LineTable->Table = relocateLineTable(
+                *Unit, *LinkContext.DwarfContext, LinkContext.Ranges);
+          });
+        }
+      }
+
+      if (HasValidRelocs || LLVM_UNLIKELY(Options.Update))
         DIECloner(*this, LinkContext.RelocMgr, DIEAlloc,
                   LinkContext.CompileUnits, Options)
             .cloneAllCompileUnits(*LinkContext.DwarfContext, LinkContext.DMO,
-                                  LinkContext.Ranges, OffsetsStringPool);
+                                  LinkContext.Ranges, OffsetsStringPool,
+                                  LineTables);
+      // Units without a DIE are skipped by cloneAllCompileUnits(), make sure
+      // nothing still refers to the units before they go away.
+      for (PendingLineTable &LineTable : LineTables)
+        LineTable.Ready.wait();
       if (!Options.NoOutput && !LinkContext.CompileUnits.empty() &&
           LLVM_LIKELY(!Options.Update))
         patchFrameInfoForObject(
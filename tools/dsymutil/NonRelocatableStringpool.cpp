@@ -13,6 +13,7 @@ namespace llvm {
 namespace dsymutil {
 
 DwarfStringPoolEntryRef NonRelocatableStringpool::getEntry(StringRef S) {
+  std::lock_guard<std::mutex> Lock(StringsMutex);
   if (S.empty() && !Strings.empty())
     return EmptyString;
 
@@ -29,12 +30,14 @@ DwarfStringPoolEntryRef NonRelocatableStringpool::getEntry(StringRef S) {
 
 StringRef NonRelocatableStringpool::internString(StringRef S) {
   DwarfStringPoolEntry Entry{nullptr, 0, -1U};
+  std::lock_guard<std::mutex> Lock(StringsMutex);
   auto InsertResult = Strings.insert({S, Entry});
   return InsertResult.first->getKey();
 }
 
 std::vector<DwarfStringPoolEntryRef>
 NonRelocatableStringpool::getEntries() const {
+  std::lock_guard<std::mutex> Lock(StringsMutex);
   std::vector<DwarfStringPoolEntryRef> Result;
   Result.reserve(Strings.size());
   for (const auto &E : Strings)
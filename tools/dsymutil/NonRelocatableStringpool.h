@@ -15,6 +15,7 @@
 #include "llvm/CodeGen/DwarfStringPoolEntry.h"
 #include "llvm/Support/Allocator.h"
 #include <cstdint>
+#include <mutex>
 #include <vector>
 
 namespace llvm {
@@ -25,6 +26,11 @@ namespace dsymutil {
 /// We are doing a final link, no need for a string table that has relocation
 /// entries for every reference to it. This class provides this ability by just
 /// associating offsets with strings.
+///
+/// The pool can be shared between threads: the entries it hands out stay
+/// valid while other threads insert. Offsets are assigned in insertion order
+/// though, so the output is only reproducible when getEntry() and
+/// getStringOffset() are called from a single thread or in a fixed order.
 class NonRelocatableStringpool {
 public:
   /// Entries are stored into the StringMap and simply linked together through
@@ -51,11 +57,15 @@ public:
   /// in place of \p S.
   StringRef internString(StringRef S);
 
-  uint64_t getSize() { return CurrentEndOffset; }
+  uint64_t getSize() {
+    std::lock_guard<std::mutex> Lock(StringsMutex);
+    return CurrentEndOffset;
+  }
 
   std::vector<DwarfStringPoolEntryRef> getEntries() const;
 
 private:
+  mutable std::mutex StringsMutex;
   MapTy Strings;
   uint32_t CurrentEndOffset = 0;
   unsigned NumEntries = 0;
@@ -98,7 +98,8 @@ static alias UpdateA("u", desc("Alias for --update"), aliasopt(Update));
 static opt<unsigned> NumThreads(
     "num-threads",
     desc("Specifies the maximum number (n) of simultaneous threads to use\n"
-         "when linking multiple architectures."),
+         "when linking multiple architectures, and when reading and\n"
+         "relocating the debug info of the objects of one architecture."),
     value_desc("n"), init(0), cat(DsymCategory));
 static alias NumThreadsA("j", desc("Alias for --num-threads"),
                          aliasopt(NumThreads));
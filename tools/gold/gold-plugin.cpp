@@ -138,6 +138,8 @@ namespace options {
   static unsigned Parallelism = 0;
   // Default regular LTO codegen parallelism (number of partitions).
   static unsigned ParallelCodeGenParallelismLevel = 1;
+  // Keep the module's function order across regular LTO codegen partitions.
+  static bool PreservePartitionOrder = false;
 #ifdef NDEBUG
   static bool DisableVerify = true;
 #else
@@ -262,6 +264,8 @@ namespace options {
       if (opt.substr(strlen("lto-partitions="))
               .getAsInteger(10, ParallelCodeGenParallelismLevel))
         message(LDPL_FATAL, "Invalid codegen partition level: %s", opt_ + 5);
+    } else if (opt == "lto-partitions-preserve-order") {
+      PreservePartitionOrder = true;
     } else if (opt == "disable-verify") {
       DisableVerify = true;
     } else if (opt.startswith("sample-profile=")) {
@@ -843,6 +847,7 @@ static std::unique_ptr<LTO> createLTO(IndexWriteCallback OnIndexWrite,
   Conf.CGOptLevel = getCGOptLevel();
   Conf.DisableVerify = options::DisableVerify;
   Conf.OptLevel = options::OptLevel;
+  Conf.SplitCodeGenPreserveOrder = options::PreservePartitionOrder;
   if (options::Parallelism)
     Backend = createInProcessThinBackend(options::Parallelism);
   if (options::thinlto_index_only) {
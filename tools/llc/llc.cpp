@@ -36,6 +36,7 @@
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Pass.h"
+#include "llvm/Remarks/BinaryRemarkWriter.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
@@ -144,9 +145,20 @@ static cl::opt<unsigned> PassRemarksHotnessThreshold(
 
 static cl::opt<std::string>
     RemarksFilename("pass-remarks-output",
-                    cl::desc("YAML output filename for pass remarks"),
+                    cl::desc("Output filename for pass remarks"),
                     cl::value_desc("filename"));
 
+namespace {
+enum class RemarksFormatKind { YAML, Binary };
+} // end anonymous namespace
+
+static cl::opt<RemarksFormatKind> RemarksFormat(
+    "pass-remarks-format", cl::desc("The format of the pass remarks file"),
+    cl::init(RemarksFormatKind::YAML),
+    cl::values(clEnumValN(RemarksFormatKind::YAML, "yaml", "YAML (default)"),
+               clEnumValN(RemarksFormatKind::Binary, "binary",
+                          "Compact binary format, see llvm-remarkutil")));
+
 namespace {
 static ManagedStatic<std::vector<std::string>> RunPassNames;
 
@@ -333,8 +345,12 @@ int main(int argc, char **argv) {
       errs() << EC.message() << '\n';
       return 1;
     }
-    Context.setDiagnosticsOutputFile(
-        llvm::make_unique<yaml::Output>(YamlFile->os()));
+    if (RemarksFormat == RemarksFormatKind::Binary)
+      Context.setDiagnosticsBinaryOutput(
+          llvm::make_unique<remarks::BinaryRemarkWriter>(YamlFile->os()));
+    else
+      Context.setDiagnosticsOutputFile(
+          llvm::make_unique<yaml::Output>(YamlFile->os()));
   }
 
   if (InputLanguage != "" && InputLanguage != "ir" &&
@@ -12,6 +12,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/IR/LLVMContext.h"
@@ -77,6 +78,7 @@ OPTIONS:
     =darwin                         -   darwin
     =bsd                            -   bsd
   -plugin=<string>                  - plugin (ignored for compatibility
+  -symbol-index                     - Store a hash index of the symbol table
   -help                             - Display available options
   -version                          - Display the version of this program
 
@@ -177,6 +179,7 @@ static bool Verbose = false;       ///< 'v' modifier
 static bool Symtab = true;         ///< 's' modifier
 static bool Deterministic = true;  ///< 'D' and 'U' modifiers
 static bool Thin = false;          ///< 'T' modifier
+static bool SymbolIndex = false;   ///< -symbol-index option
 
 // Relative Positional Argument (for insert/move). This variable holds
 // the name of the archive member to which the 'a', 'b' or 'i' modifier
@@ -495,13 +498,38 @@ static void addMember(std::vector<NewArchiveMember> &Members,
     Members[Pos] = std::move(*NMOrErr);
 }
 
+using MemberSymbolsMap = DenseMap<uint64_t, std::vector<StringRef>>;
+
+// Collect the names the symbol table of Archive lists for each of its members,
+// keyed by the offset of the member. The members that are carried over to the
+// new archive then don't have to be parsed again to rebuild the symbol table.
+static MemberSymbolsMap getMemberSymbols(const object::Archive &Archive) {
+  MemberSymbolsMap Ret;
+  if (!Symtab || !Archive.hasSymbolTable())
+    return Ret;
+  for (const object::Archive::Symbol &S : Archive.symbols()) {
+    Expected<object::Archive::Child> MemberOrErr = S.getMember();
+    if (!MemberOrErr) {
+      // Fall back to reading the symbols from the members.
+      consumeError(MemberOrErr.takeError());
+      return MemberSymbolsMap();
+    }
+    Ret[MemberOrErr->getChildOffset()].push_back(S.getName());
+  }
+  return Ret;
+}
+
 static void addMember(std::vector<NewArchiveMember> &Members,
-                      const object::Archive::Child &M, int Pos = -1) {
+                      const object::Archive::Child &M,
+                      const MemberSymbolsMap &OldSymbols, int Pos = -1) {
   if (Thin && !M.getParent()->isThin())
     fail("Cannot convert a regular archive to a thin one");
   Expected<NewArchiveMember> NMOrErr =
       NewArchiveMember::getOldMember(M, Deterministic);
   failIfError(NMOrErr.takeError());
+  auto Symbols = OldSymbols.find(M.getChildOffset());
+  if (Symbols != OldSymbols.end())
+    NMOrErr->Symbols = Symbols->second;
   if (Pos == -1)
     Members.push_back(std::move(*NMOrErr));
   else
@@ -575,6 +603,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
   int InsertPos = -1;
   StringRef PosName = sys::path::filename(RelPos);
   if (OldArchive) {
+    MemberSymbolsMap OldSymbols = getMemberSymbols(*OldArchive);
     Error Err = Error::success();
     for (auto &Child : OldArchive->children(Err)) {
       int Pos = Ret.size();
@@ -594,7 +623,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
           computeInsertAction(Operation, Child, Name, MemberI);
       switch (Action) {
       case IA_AddOldMember:
-        addMember(Ret, Child);
+        addMember(Ret, Child, OldSymbols);
         break;
       case IA_AddNewMember:
         addMember(Ret, *MemberI);
@@ -602,7 +631,7 @@ computeNewArchiveMembers(ArchiveOperation Operation,
       case IA_Delete:
         break;
       case IA_MoveOldMember:
-        addMember(Moved, Child);
+        addMember(Moved, Child, OldSymbols);
         break;
       case IA_MoveNewMember:
         addMember(Moved, *MemberI);
@@ -703,7 +732,8 @@ performWriteOperation(ArchiveOperation Operation,
 
   Error E =
       writeArchive(ArchiveName, NewMembersP ? *NewMembersP : NewMembers, Symtab,
-                   Kind, Deterministic, Thin, std::move(OldArchiveBuf));
+                   Kind, Deterministic, Thin, std::move(OldArchiveBuf),
+                   SymbolIndex);
   failIfError(std::move(E), ArchiveName);
 }
 
@@ -818,9 +848,10 @@ static void runMRIScript() {
       Archives.push_back(std::move(*LibOrErr));
       object::Archive &Lib = *Archives.back();
       {
+        MemberSymbolsMap LibSymbols = getMemberSymbols(Lib);
         Error Err = Error::success();
         for (auto &Member : Lib.children(Err))
-          addMember(NewMembers, Member);
+          addMember(NewMembers, Member, LibSymbols);
         failIfError(std::move(Err));
       }
       break;
@@ -918,6 +949,8 @@ static int ar_main(int argc, char **argv) {
           fail(std::string("Invalid format ") + match);
       } else if (MatchFlagWithArg("plugin")) {
         // Ignored.
+      } else if (Arg == "symbol-index") {
+        SymbolIndex = true;
       } else {
         Options += Argv[i] + 1;
       }
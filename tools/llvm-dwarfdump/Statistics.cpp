@@ -3,6 +3,7 @@
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugLoc.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/ThreadPool.h"
 
 #define DEBUG_TYPE "dwarfdump"
 using namespace llvm;
@@ -160,6 +161,26 @@ static void collectStatsRecursive(DWARFDie Die, std::string Prefix,
   }
 }
 
+/// Add the statistics collected for one compile unit to the totals.
+static void mergeStats(StringMap<PerFunctionStats> &FnStatMap,
+                       GlobalStats &GlobalStats,
+                       const StringMap<PerFunctionStats> &UnitFnStatMap,
+                       const struct GlobalStats &UnitGlobalStats) {
+  for (const auto &Entry : UnitFnStatMap) {
+    const PerFunctionStats &UnitStats = Entry.getValue();
+    PerFunctionStats &Stats = FnStatMap[Entry.getKey()];
+    Stats.NumFnInlined += UnitStats.NumFnInlined;
+    Stats.TotalVarWithLoc += UnitStats.TotalVarWithLoc;
+    Stats.ConstantMembers += UnitStats.ConstantMembers;
+    Stats.VarsInFunction.insert(UnitStats.VarsInFunction.begin(),
+                                UnitStats.VarsInFunction.end());
+    Stats.IsFunction |= UnitStats.IsFunction;
+  }
+  GlobalStats.ScopeBytesCovered += UnitGlobalStats.ScopeBytesCovered;
+  GlobalStats.ScopeBytesFromFirstDefinition +=
+      UnitGlobalStats.ScopeBytesFromFirstDefinition;
+}
+
 /// Print machine-readable output.
 /// The machine-readable format is single-line JSON output.
 /// \{
@@ -181,14 +202,38 @@ static void printDatum(raw_ostream &OS, const char *Key, uint64_t Value) {
 /// of particular optimizations. The raw numbers themselves are not particularly
 /// useful, only the delta between compiling the same program with different
 /// compilers is.
+///
+/// With more than one thread, each compile unit is measured on its own and
+/// the results are added up afterwards, which gives the same numbers.
 bool collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
-                               Twine Filename, raw_ostream &OS) {
+                               Twine Filename, raw_ostream &OS,
+                               unsigned NumThreads) {
   StringRef FormatName = Obj.getFileFormatName();
   GlobalStats GlobalStats;
   StringMap<PerFunctionStats> Statistics;
-  for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units())
-    if (DWARFDie CUDie = CU->getUnitDIE(false))
-      collectStatsRecursive(CUDie, "/", 0, 0, Statistics, GlobalStats);
+  if (NumThreads > 1) {
+    DICtx.extractCompileUnits(NumThreads);
+    unsigned NumUnits = DICtx.getNumCompileUnits();
+    std::vector<StringMap<PerFunctionStats>> UnitStatistics(NumUnits);
+    std::vector<struct GlobalStats> UnitGlobalStats(NumUnits);
+    ThreadPool Pool(NumThreads);
+    for (unsigned I = 0; I != NumUnits; ++I) {
+      DWARFCompileUnit *CU = DICtx.getCompileUnitAtIndex(I);
+      Pool.async([=, &UnitStatistics, &UnitGlobalStats] {
+        if (DWARFDie CUDie = CU->getUnitDIE(false))
+          collectStatsRecursive(CUDie, "/", 0, 0, UnitStatistics[I],
+                                UnitGlobalStats[I]);
+      });
+    }
+    Pool.wait();
+    for (unsigned I = 0; I != NumUnits; ++I)
+      mergeStats(Statistics, GlobalStats, UnitStatistics[I],
+                 UnitGlobalStats[I]);
+  } else {
+    for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units())
+      if (DWARFDie CUDie = CU->getUnitDIE(false))
+        collectStatsRecursive(CUDie, "/", 0, 0, Statistics, GlobalStats);
+  }
 
   /// The version number should be increased every time the algorithm is changed
   /// (including bug fixes). New metrics may be added without increasing the
@@ -27,6 +27,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
@@ -209,6 +210,13 @@ static cl::opt<bool>
                cat(DwarfDumpCategory));
 static opt<bool> Verify("verify", desc("Verify the DWARF debug info."),
                         cat(DwarfDumpCategory));
+static opt<unsigned>
+    NumThreads("num-threads",
+               desc("Number of threads to use for -verify and -statistics. "
+                    "0 means one per hardware thread."),
+               cat(DwarfDumpCategory), init(1), value_desc("N"));
+static alias NumThreadsAlias("j", desc("Alias for -num-threads."),
+                             aliasopt(NumThreads));
 static opt<bool> Quiet("quiet", desc("Use with -verify to not emit to STDOUT."),
                        cat(DwarfDumpCategory));
 static opt<bool> DumpUUID("uuid", desc("Show the UUID for each architecture."),
@@ -246,6 +254,12 @@ static DIDumpOptions getDumpOpts() {
   return DumpOpts;
 }
 
+static unsigned getNumThreads() {
+  if (NumThreads == 0)
+    return llvm::hardware_concurrency();
+  return NumThreads;
+}
+
 static uint32_t getCPUType(MachOObjectFile &MachO) {
   if (MachO.is64Bit())
     return MachO.getHeader64().cputype;
@@ -333,7 +347,8 @@ static bool lookup(DWARFContext &DICtx, uint64_t Address, raw_ostream &OS) {
 }
 
 bool collectStatsForObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
-                               Twine Filename, raw_ostream &OS);
+                               Twine Filename, raw_ostream &OS,
+                               unsigned NumThreads);
 
 template <typename AccelTable>
 static llvm::Optional<uint64_t> getDIEOffset(const AccelTable &Accel,
@@ -399,7 +414,7 @@ static bool verifyObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
   raw_ostream &stream = Quiet ? nulls() : OS;
   stream << "Verifying " << Filename.str() << ":\tfile format "
   << Obj.getFileFormatName() << "\n";
-  bool Result = DICtx.verify(stream, getDumpOpts());
+  bool Result = DICtx.verify(stream, getDumpOpts(), getNumThreads());
   if (Result)
     stream << "No errors.\n";
   else
@@ -407,6 +422,11 @@ static bool verifyObjectFile(ObjectFile &Obj, DWARFContext &DICtx,
   return Result;
 }
 
+static bool collectStats(ObjectFile &Obj, DWARFContext &DICtx, Twine Filename,
+                         raw_ostream &OS) {
+  return collectStatsForObjectFile(Obj, DICtx, Filename, OS, getNumThreads());
+}
+
 static bool handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
                          HandlerFn HandleObj, raw_ostream &OS);
 
@@ -584,7 +604,7 @@ int main(int argc, char **argv) {
       exit(1);
   } else if (Statistics)
     for (auto Object : Objects)
-      handleFile(Object, collectStatsForObjectFile, OS);
+      handleFile(Object, collectStats, OS);
   else
     for (auto Object : Objects)
       handleFile(Object, dumpObjectFile, OS);
@@ -116,9 +116,11 @@ int main(int argc, char **argv) {
   LLVMContext Context;
   cl::ParseCommandLineOptions(argc, argv, "llvm extractor\n");
 
-  // Use lazy loading, since we only care about selected global values.
+  // Use lazy loading, since we only care about selected global values. This
+  // covers metadata too: only what the extracted values reference is loaded.
   SMDiagnostic Err;
-  std::unique_ptr<Module> M = getLazyIRFileModule(InputFilename, Err, Context);
+  std::unique_ptr<Module> M = getLazyIRFileModule(
+      InputFilename, Err, Context, /*ShouldLazyLoadMetadata=*/true);
 
   if (!M.get()) {
     Err.print(argv[0], errs());
@@ -125,7 +125,11 @@ static std::unique_ptr<Module> loadFile(const char *argv0,
   if (DisableLazyLoad)
     Result = parseIRFile(FN, Err, Context);
   else
-    Result = getLazyIRFileModule(FN, Err, Context, !MaterializeMetadata);
+    // When only linking what is needed, most of the metadata is typically
+    // unreferenced: materializing it below then only loads the named metadata,
+    // and the rest is loaded as the linked values are materialized.
+    Result = getLazyIRFileModule(FN, Err, Context,
+                                 !MaterializeMetadata || OnlyNeeded);
 
   if (!Result) {
     Err.print(argv0, errs());
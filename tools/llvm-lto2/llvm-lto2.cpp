@@ -21,8 +21,11 @@
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/LTO/Caching.h"
 #include "llvm/LTO/LTO.h"
+#include "llvm/Support/CacheIndex.h"
+#include "llvm/Support/CachePruning.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Threading.h"
 
@@ -49,6 +52,23 @@ static cl::opt<std::string> OutputFilename("o", cl::Required,
 static cl::opt<std::string> CacheDir("cache-dir", cl::desc("Cache Directory"),
                                      cl::value_desc("directory"));
 
+static cl::opt<bool>
+    CacheIndexed("cache-index",
+                 cl::desc("Keep an index of the cache directory and prune it "
+                          "incrementally"));
+
+static cl::opt<std::string>
+    CachePolicy("cache-policy",
+                cl::desc("Pruning policy for an indexed cache, in the format "
+                         "accepted by parseCachePruningPolicy()"),
+                cl::value_desc("policy"));
+
+static cl::opt<std::string> IncrementalIndex(
+    "incremental-index",
+    cl::desc("Save the combined summary index to this file, and reuse the "
+             "summaries of unchanged modules from it in the next link"),
+    cl::value_desc("filename"));
+
 static cl::opt<std::string> OptPipeline("opt-pipeline",
                                         cl::desc("Optimizer Pipeline"),
                                         cl::value_desc("pipeline"));
@@ -144,7 +164,7 @@ template <typename T> static T check(ErrorOr<T> E, std::string Msg) {
 }
 
 static int usage() {
-  errs() << "Available subcommands: dump-symtab run\n";
+  errs() << "Available subcommands: cache-prune cache-stats dump-symtab run\n";
   return 1;
 }
 
@@ -245,6 +265,7 @@ static int run(int argc, char **argv) {
   Conf.OverrideTriple = OverrideTriple;
   Conf.DefaultTriple = DefaultTriple;
   Conf.StatsFile = StatsFile;
+  Conf.IncrementalIndexPath = IncrementalIndex;
 
   ThinBackend Backend;
   if (ThinLTODistributedIndexes)
@@ -310,7 +331,12 @@ static int run(int argc, char **argv) {
   };
 
   NativeObjectCache Cache;
-  if (!CacheDir.empty())
+  if (!CacheDir.empty() && CacheIndexed)
+    Cache = check(indexedCache(CacheDir, AddBuffer,
+                               check(parseCachePruningPolicy(CachePolicy),
+                                     "invalid cache policy")),
+                  "failed to create cache");
+  else if (!CacheDir.empty())
     Cache = check(localCache(CacheDir, AddBuffer), "failed to create cache");
 
   check(Lto.run(AddStream, Cache), "LTO::run failed");
@@ -387,6 +413,43 @@ static int dumpSymtab(int argc, char **argv) {
   return 0;
 }
 
+static int cacheStats(int argc, char **argv) {
+  if (argc != 2) {
+    errs() << "Usage: llvm-lto2 cache-stats <cache directory>\n";
+    return 1;
+  }
+
+  std::unique_ptr<CacheIndex> Index =
+      check(CacheIndex::open(argv[1]), "failed to open cache index");
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  uint64_t Lookups = Stats.Hits + Stats.Misses;
+  outs() << "entries: " << Stats.NumEntries << '\n';
+  outs() << "total size: " << Stats.TotalSize << '\n';
+  outs() << "hits: " << Stats.Hits << '\n';
+  outs() << "misses: " << Stats.Misses << '\n';
+  outs() << "hit rate: "
+         << format("%.1f%%", Lookups ? 100.0 * Stats.Hits / Lookups : 0.0)
+         << '\n';
+  outs() << "evictions: " << Stats.Evictions << '\n';
+  return 0;
+}
+
+static int cachePrune(int argc, char **argv) {
+  if (argc != 3) {
+    errs() << "Usage: llvm-lto2 cache-prune <cache directory> <policy>\n";
+    return 1;
+  }
+
+  CachePruningPolicy Policy =
+      check(parseCachePruningPolicy(argv[2]), "invalid cache policy");
+  std::unique_ptr<CacheIndex> Index =
+      check(CacheIndex::open(argv[1]), "failed to open cache index");
+  uint64_t NumRemoved = Index->prune(Policy);
+  check(Index->compact(), "failed to compact cache index");
+  outs() << "removed: " << NumRemoved << '\n';
+  return 0;
+}
+
 int main(int argc, char **argv) {
   InitializeAllTargets();
   InitializeAllTargetMCs();
@@ -402,6 +465,10 @@ int main(int argc, char **argv) {
   StringRef Subcommand = argv[1];
   // Ensure that argv[0] is correct after adjusting argv/argc.
   argv[1] = argv[0];
+  if (Subcommand == "cache-prune")
+    return cachePrune(argc - 1, argv + 1);
+  if (Subcommand == "cache-stats")
+    return cacheStats(argc - 1, argv + 1);
   if (Subcommand == "dump-symtab")
     return dumpSymtab(argc - 1, argv + 1);
   if (Subcommand == "run")
@@ -67,6 +67,8 @@ static cl::opt<DebugCompressionType> CompressDebugSections(
     cl::values(clEnumValN(DebugCompressionType::None, "none", "No compression"),
                clEnumValN(DebugCompressionType::Z, "zlib",
                           "Use zlib compression"),
+               clEnumValN(DebugCompressionType::Zstd, "zstd",
+                          "Use zstd compression"),
                clEnumValN(DebugCompressionType::GNU, "zlib-gnu",
                           "Use zlib-gnu compression (deprecated)")));
 
@@ -348,7 +350,13 @@ int main(int argc, char **argv) {
   MAI->setRelaxELFRelocations(RelaxELFRel);
 
   if (CompressDebugSections != DebugCompressionType::None) {
-    if (!zlib::isAvailable()) {
+    if (CompressDebugSections == DebugCompressionType::Zstd) {
+      if (!zstd::isAvailable()) {
+        WithColor::error(errs(), ProgName)
+            << "build tools with zstd to enable -compress-debug-sections=zstd";
+        return 1;
+      }
+    } else if (!zlib::isAvailable()) {
       WithColor::error(errs(), ProgName)
           << "build tools with zlib to enable -compress-debug-sections";
       return 1;
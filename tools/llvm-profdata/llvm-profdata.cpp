@@ -154,30 +154,19 @@ static bool isFatalError(instrprof_error IPE) {
   }
 }
 
-/// Load an input into a writer context.
-static void loadInput(const WeightedFile &Input, WriterContext *WC) {
-  std::unique_lock<std::mutex> CtxGuard{WC->Lock};
-
-  // If there's a pending hard error, don't do more work.
-  if (WC->Err)
-    return;
-
-  // Copy the filename, because llvm::ThreadPool copied the input "const
-  // WeightedFile &" by value, making a reference to the filename within it
-  // invalid outside of this packaged task.
-  WC->ErrWhence = Input.Filename;
-
-  auto ReaderOrErr = InstrProfReader::create(Input.Filename);
-  if (Error E = ReaderOrErr.takeError()) {
-    // Skip the empty profiles by returning sliently.
-    instrprof_error IPE = InstrProfError::take(std::move(E));
-    if (IPE != instrprof_error::empty_raw_profile)
-      WC->Err = make_error<InstrProfError>(IPE);
-    return;
-  }
+/// Record the error from opening an input in \p WC. Empty profiles are
+/// skipped silently.
+static void handleOpenError(Error E, WriterContext *WC) {
+  instrprof_error IPE = InstrProfError::take(std::move(E));
+  if (IPE != instrprof_error::empty_raw_profile)
+    WC->Err = make_error<InstrProfError>(IPE);
+}
 
-  auto Reader = std::move(ReaderOrErr.get());
-  bool IsIRProfile = Reader->isIRLevelProfile();
+/// Add \p Records, read from \p Reader, to a writer context.
+template <typename RecordRange>
+static void addRecords(const WeightedFile &Input, InstrProfReader &Reader,
+                       RecordRange &&Records, WriterContext *WC) {
+  bool IsIRProfile = Reader.isIRLevelProfile();
   if (WC->Writer.setIsIRLevelProfile(IsIRProfile)) {
     WC->Err = make_error<StringError>(
         "Merge IR generated profile with Clang generated profile.",
@@ -185,7 +174,7 @@ static void loadInput(const WeightedFile &Input, WriterContext *WC) {
     return;
   }
 
-  for (auto &I : *Reader) {
+  for (auto &I : Records) {
     const StringRef FuncName = I.Name;
     bool Reported = false;
     WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
@@ -202,8 +191,8 @@ static void loadInput(const WeightedFile &Input, WriterContext *WC) {
                              FuncName, firstTime);
     });
   }
-  if (Reader->hasError()) {
-    if (Error E = Reader->getError()) {
+  if (Reader.hasError()) {
+    if (Error E = Reader.getError()) {
       instrprof_error IPE = InstrProfError::take(std::move(E));
       if (isFatalError(IPE))
         WC->Err = make_error<InstrProfError>(IPE);
@@ -211,6 +200,92 @@ static void loadInput(const WeightedFile &Input, WriterContext *WC) {
   }
 }
 
+/// Load an input into a writer context.
+static void loadInput(const WeightedFile &Input, WriterContext *WC) {
+  std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+
+  // If there's a pending hard error, don't do more work.
+  if (WC->Err)
+    return;
+
+  // Copy the filename, because llvm::ThreadPool copied the input "const
+  // WeightedFile &" by value, making a reference to the filename within it
+  // invalid outside of this packaged task.
+  WC->ErrWhence = Input.Filename;
+
+  auto ReaderOrErr = InstrProfReader::create(Input.Filename);
+  if (Error E = ReaderOrErr.takeError())
+    return handleOpenError(std::move(E), WC);
+
+  auto Reader = std::move(ReaderOrErr.get());
+  addRecords(Input, *Reader, *Reader, WC);
+}
+
+/// The records of an input, read ahead of a streaming merge.
+struct PrefetchedInput {
+  std::unique_ptr<InstrProfReader> Reader;
+  std::vector<NamedInstrProfRecord> Records;
+  Error Err = Error::success();
+};
+
+/// Read all the records of \p Input into \p PI.
+static void prefetchInput(const WeightedFile &Input, PrefetchedInput *PI) {
+  auto ReaderOrErr = InstrProfReader::create(Input.Filename);
+  if (Error E = ReaderOrErr.takeError()) {
+    PI->Err = std::move(E);
+    return;
+  }
+  PI->Reader = std::move(ReaderOrErr.get());
+  // The record names point into the reader, which is kept alive with them.
+  for (auto &I : *PI->Reader)
+    PI->Records.push_back(std::move(I));
+}
+
+/// Merge the inputs one at a time, in order, into a single writer context.
+/// Up to 2 * NumThreads inputs are read ahead by a thread pool, so memory is
+/// bounded by the merged profile plus a fixed number of inputs, instead of
+/// growing with the number of threads as with per-thread writer contexts.
+static void streamInputs(const WeightedFileVector &Inputs, WriterContext *WC,
+                         unsigned NumThreads) {
+  if (NumThreads == 1) {
+    for (const auto &Input : Inputs)
+      loadInput(Input, WC);
+    return;
+  }
+
+  std::vector<std::unique_ptr<PrefetchedInput>> Prefetched(Inputs.size());
+  std::vector<std::shared_future<void>> Futures(Inputs.size());
+  ThreadPool Pool(NumThreads);
+  size_t Window = 2 * NumThreads;
+  auto Prefetch = [&](size_t I) {
+    Prefetched[I] = llvm::make_unique<PrefetchedInput>();
+    Futures[I] = Pool.async(prefetchInput, Inputs[I], Prefetched[I].get());
+  };
+  for (size_t I = 0, E = std::min(Window, Inputs.size()); I != E; ++I)
+    Prefetch(I);
+
+  for (size_t I = 0, E = Inputs.size(); I != E; ++I) {
+    // Nothing more is read after a hard error, but the inputs that were
+    // already being read are drained.
+    if (!Prefetched[I])
+      continue;
+    Futures[I].wait();
+    std::unique_ptr<PrefetchedInput> PI = std::move(Prefetched[I]);
+    if (!WC->Err) {
+      WC->ErrWhence = Inputs[I].Filename;
+      if (PI->Err)
+        handleOpenError(std::move(PI->Err), WC);
+      else
+        addRecords(Inputs[I], *PI->Reader, PI->Records, WC);
+    } else {
+      consumeError(std::move(PI->Err));
+    }
+    PI.reset();
+    if (I + Window < E && !WC->Err)
+      Prefetch(I + Window);
+  }
+}
+
 /// Merge the \p Src writer context into \p Dst.
 static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   // If we've already seen a hard error, continuing with the merge would
@@ -232,17 +307,33 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
 static void mergeInstrProfile(const WeightedFileVector &Inputs,
                               StringRef OutputFilename,
                               ProfileFormat OutputFormat, bool OutputSparse,
-                              unsigned NumThreads) {
+                              unsigned NumThreads, bool Stream,
+                              bool Incremental) {
   if (OutputFilename.compare("-") == 0)
     exitWithError("Cannot write indexed profdata format to stdout.");
 
   if (OutputFormat != PF_Binary && OutputFormat != PF_Text)
     exitWithError("Unknown format is specified.");
 
-  std::error_code EC;
-  raw_fd_ostream Output(OutputFilename.data(), EC, sys::fs::F_None);
-  if (EC)
-    exitWithErrorCode(EC, OutputFilename);
+  // An incremental merge reads the existing output like any other input, so
+  // the output is only opened once everything has been merged.
+  std::unique_ptr<raw_fd_ostream> Output;
+  auto OpenOutput = [&] {
+    std::error_code EC;
+    Output = llvm::make_unique<raw_fd_ostream>(OutputFilename.data(), EC,
+                                               sys::fs::F_None);
+    if (EC)
+      exitWithErrorCode(EC, OutputFilename);
+  };
+  WeightedFileVector IncrementalInputs;
+  if (Incremental && sys::fs::exists(OutputFilename)) {
+    IncrementalInputs.push_back({OutputFilename, 1});
+    IncrementalInputs.append(Inputs.begin(), Inputs.end());
+  } else {
+    OpenOutput();
+  }
+  const WeightedFileVector &AllInputs =
+      IncrementalInputs.empty() ? Inputs : IncrementalInputs;
 
   std::mutex ErrorLock;
   SmallSet<instrprof_error, 4> WriterErrorCodes;
@@ -250,23 +341,25 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   // If NumThreads is not specified, auto-detect a good default.
   if (NumThreads == 0)
     NumThreads =
-        std::min(hardware_concurrency(), unsigned((Inputs.size() + 1) / 2));
+        std::min(hardware_concurrency(), unsigned((AllInputs.size() + 1) / 2));
 
-  // Initialize the writer contexts.
+  // Initialize the writer contexts. A streaming merge only needs one.
   SmallVector<std::unique_ptr<WriterContext>, 4> Contexts;
-  for (unsigned I = 0; I < NumThreads; ++I)
+  for (unsigned I = 0; I < (Stream ? 1 : NumThreads); ++I)
     Contexts.emplace_back(llvm::make_unique<WriterContext>(
         OutputSparse, ErrorLock, WriterErrorCodes));
 
-  if (NumThreads == 1) {
-    for (const auto &Input : Inputs)
+  if (Stream) {
+    streamInputs(AllInputs, Contexts[0].get(), NumThreads);
+  } else if (NumThreads == 1) {
+    for (const auto &Input : AllInputs)
       loadInput(Input, Contexts[0].get());
   } else {
     ThreadPool Pool(NumThreads);
 
     // Load the inputs in parallel (N/NumThreads serial steps).
     unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
+    for (const auto &Input : AllInputs) {
       Pool.async(loadInput, Input, Contexts[Ctx].get());
       Ctx = (Ctx + 1) % NumThreads;
     }
@@ -306,12 +399,14 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
            WC->ErrWhence);
   }
 
+  if (!Output)
+    OpenOutput();
   InstrProfWriter &Writer = Contexts[0]->Writer;
   if (OutputFormat == PF_Text) {
-    if (Error E = Writer.writeText(Output))
+    if (Error E = Writer.writeText(*Output))
       exitWithError(std::move(E));
   } else {
-    Writer.write(Output);
+    Writer.write(*Output);
   }
 }
 
@@ -476,6 +571,15 @@ static int merge_main(int argc, const char *argv[]) {
       cl::desc("Number of merge threads to use (default: autodetect)"));
   cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
                         cl::aliasopt(NumThreads));
+  cl::opt<bool> Stream(
+      "stream", cl::init(false),
+      cl::desc("Merge the inputs one at a time into a single profile, reading "
+               "ahead on the merge threads, to bound memory use (only "
+               "meaningful for -instr)"));
+  cl::opt<bool> Incremental(
+      "incremental", cl::init(false),
+      cl::desc("Merge the inputs into the profile already in the output file, "
+               "if there is one (only meaningful for -instr)"));
 
   cl::ParseCommandLineOptions(argc, argv, "LLVM profile data merger\n");
 
@@ -502,7 +606,7 @@ static int merge_main(int argc, const char *argv[]) {
 
   if (ProfileKind == instr)
     mergeInstrProfile(WeightedInputs, OutputFilename, OutputFormat,
-                      OutputSparse, NumThreads);
+                      OutputSparse, NumThreads, Stream, Incremental);
   else
     mergeSampleProfile(WeightedInputs, OutputFilename, OutputFormat);
 
@@ -0,0 +1,317 @@
+//===- llvm-remarkutil.cpp - Convert and summarize remark files -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program reads optimization remark files written in the binary remark
+// format, and either converts them, for example to the YAML that opt-viewer
+// reads, or summarizes them. Both can be restricted to some of the remarks.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Remarks/BinaryRemarkReader.h"
+#include "llvm/Remarks/BinaryRemarkWriter.h"
+#include "llvm/Remarks/YAMLRemarkWriter.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Regex.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+static ExitOnError ExitOnErr;
+
+static cl::SubCommand ConvertSubcommand(
+    "convert", "Convert remark files, concatenating them and keeping only the "
+               "remarks that pass the filters");
+static cl::SubCommand SummarySubcommand(
+    "summary", "Count the remarks that pass the filters, grouped by a key");
+
+static cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<input files>"),
+                                            cl::sub(ConvertSubcommand),
+                                            cl::sub(SummarySubcommand));
+
+static cl::opt<std::string> OutputFilename("o", cl::desc("Output filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"),
+                                           cl::sub(ConvertSubcommand),
+                                           cl::sub(SummarySubcommand));
+
+// Filters.
+static cl::opt<std::string>
+    PassFilter("pass", cl::desc("Only keep the remarks of matching passes"),
+               cl::value_desc("regex"), cl::sub(ConvertSubcommand),
+               cl::sub(SummarySubcommand));
+static cl::opt<std::string>
+    NameFilter("remark-name", cl::desc("Only keep the remarks with a matching "
+                                       "name"),
+               cl::value_desc("regex"), cl::sub(ConvertSubcommand),
+               cl::sub(SummarySubcommand));
+static cl::opt<std::string>
+    FunctionFilter("function",
+                   cl::desc("Only keep the remarks about matching functions"),
+                   cl::value_desc("regex"), cl::sub(ConvertSubcommand),
+                   cl::sub(SummarySubcommand));
+static cl::list<std::string>
+    TypeFilter("type", cl::desc("Only keep the remarks of these types, such as "
+                                "passed, missed, analysis or failure"),
+               cl::CommaSeparated, cl::sub(ConvertSubcommand),
+               cl::sub(SummarySubcommand));
+static cl::opt<unsigned long long>
+    MinHotness("min-hotness",
+               cl::desc("Only keep the remarks at least this hot, which "
+                        "excludes the remarks without a hotness"),
+               cl::init(0), cl::sub(ConvertSubcommand),
+               cl::sub(SummarySubcommand));
+
+// Options of convert.
+namespace {
+enum class OutputFormatKind { YAML, Binary };
+} // end anonymous namespace
+
+static cl::opt<OutputFormatKind> OutputFormat(
+    "to", cl::desc("The format to convert to"),
+    cl::init(OutputFormatKind::YAML),
+    cl::values(clEnumValN(OutputFormatKind::YAML, "yaml", "YAML (default)"),
+               clEnumValN(OutputFormatKind::Binary, "binary",
+                          "The binary remark format")),
+    cl::sub(ConvertSubcommand));
+
+// Options of summary.
+namespace {
+enum class GroupKind { Pass, Name, Function };
+} // end anonymous namespace
+
+static cl::opt<GroupKind> GroupBy(
+    "by", cl::desc("The key to group remarks by"), cl::init(GroupKind::Name),
+    cl::values(clEnumValN(GroupKind::Pass, "pass", "The pass name"),
+               clEnumValN(GroupKind::Name, "name",
+                          "The pass and remark names (default)"),
+               clEnumValN(GroupKind::Function, "function",
+                          "The function name")),
+    cl::sub(SummarySubcommand));
+static cl::opt<bool> CSV("csv", cl::desc("Print the summary as CSV"),
+                         cl::sub(SummarySubcommand));
+
+namespace {
+/// The filters of the command line.
+class RemarkFilter {
+public:
+  RemarkFilter();
+  bool matches(const Remark &R);
+
+private:
+  static Optional<Regex> makeRegex(StringRef Option, StringRef Pattern);
+
+  Optional<Regex> Pass, Name, Function;
+  SmallVector<Type, 6> Types;
+};
+} // end anonymous namespace
+
+Optional<Regex> RemarkFilter::makeRegex(StringRef Option, StringRef Pattern) {
+  if (Pattern.empty())
+    return None;
+  Regex R(Pattern);
+  std::string Err;
+  if (!R.isValid(Err))
+    ExitOnErr(make_error<StringError>("invalid regex for -" + Option + ": " +
+                                          Err,
+                                      inconvertibleErrorCode()));
+  return std::move(R);
+}
+
+RemarkFilter::RemarkFilter()
+    : Pass(makeRegex("pass", PassFilter)),
+      Name(makeRegex("remark-name", NameFilter)),
+      Function(makeRegex("function", FunctionFilter)) {
+  for (StringRef TypeName : TypeFilter) {
+    // Accept the names in lower case as well.
+    std::string Capitalized = TypeName;
+    if (!Capitalized.empty())
+      Capitalized[0] = toupper(Capitalized[0]);
+    Optional<Type> T = parseTypeName(Capitalized);
+    if (!T)
+      ExitOnErr(make_error<StringError>("unknown remark type '" + TypeName +
+                                            "'",
+                                        inconvertibleErrorCode()));
+    Types.push_back(*T);
+  }
+}
+
+bool RemarkFilter::matches(const Remark &R) {
+  if (Pass && !Pass->match(R.PassName))
+    return false;
+  if (Name && !Name->match(R.RemarkName))
+    return false;
+  if (Function && !Function->match(R.FunctionName))
+    return false;
+  if (!Types.empty() && !is_contained(Types, R.RemarkType))
+    return false;
+  if (MinHotness && (!R.Hotness || *R.Hotness < MinHotness))
+    return false;
+  return true;
+}
+
+/// Call \p Callback on each remark of the input files that passes the
+/// filters.
+static void forEachRemark(function_ref<void(const Remark &)> Callback) {
+  RemarkFilter Filter;
+  for (const std::string &Filename : InputFilenames) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+        MemoryBuffer::getFileOrSTDIN(Filename);
+    if (std::error_code EC = BufOrErr.getError())
+      ExitOnErr(errorCodeToError(EC));
+    StringRef Buf = (*BufOrErr)->getBuffer();
+    ExitOnErr.setBanner("llvm-remarkutil: " + Filename + ": ");
+    if (!Buf.empty() && !BinaryRemarkReader::isBinaryRemarks(Buf))
+      ExitOnErr(make_error<StringError>(
+          "not a binary remark file; YAML files can be read by opt-viewer",
+          inconvertibleErrorCode()));
+    if (Buf.empty())
+      continue;
+
+    std::unique_ptr<BinaryRemarkReader> Reader =
+        ExitOnErr(BinaryRemarkReader::create(Buf));
+    while (const Remark *R = ExitOnErr(Reader->next()))
+      if (Filter.matches(*R))
+        Callback(*R);
+  }
+  ExitOnErr.setBanner("llvm-remarkutil: ");
+}
+
+static std::unique_ptr<ToolOutputFile> openOutput() {
+  std::error_code EC;
+  auto Out =
+      llvm::make_unique<ToolOutputFile>(OutputFilename, EC, sys::fs::F_None);
+  if (EC)
+    ExitOnErr(errorCodeToError(EC));
+  return Out;
+}
+
+static void convert() {
+  std::unique_ptr<ToolOutputFile> Out = openOutput();
+  if (OutputFormat == OutputFormatKind::Binary) {
+    BinaryRemarkWriter Writer(Out->os());
+    forEachRemark([&](const Remark &R) { Writer.emit(R); });
+  } else {
+    YAMLRemarkWriter Writer(Out->os());
+    forEachRemark([&](const Remark &R) { Writer.emit(R); });
+  }
+  Out->keep();
+}
+
+namespace {
+struct GroupSummary {
+  uint64_t Counts[6] = {};
+  uint64_t Total = 0;
+  uint64_t Hotness = 0;
+};
+} // end anonymous namespace
+
+static void summarize() {
+  StringMap<GroupSummary> Groups;
+  forEachRemark([&](const Remark &R) {
+    std::string Key;
+    switch (GroupBy) {
+    case GroupKind::Pass:
+      Key = R.PassName;
+      break;
+    case GroupKind::Name:
+      Key = (R.PassName + "/" + R.RemarkName).str();
+      break;
+    case GroupKind::Function:
+      Key = R.FunctionName;
+      break;
+    }
+    GroupSummary &G = Groups[Key];
+    ++G.Counts[static_cast<unsigned>(R.RemarkType)];
+    ++G.Total;
+    if (R.Hotness)
+      G.Hotness += *R.Hotness;
+  });
+
+  // Print the groups in a stable order, the most frequent first.
+  std::vector<const StringMapEntry<GroupSummary> *> Sorted;
+  size_t KeyWidth = 3;
+  for (const StringMapEntry<GroupSummary> &G : Groups) {
+    Sorted.push_back(&G);
+    KeyWidth = std::max(KeyWidth, G.getKey().size());
+  }
+  llvm::sort(Sorted.begin(), Sorted.end(),
+             [](const StringMapEntry<GroupSummary> *A,
+                const StringMapEntry<GroupSummary> *B) {
+               if (A->getValue().Total != B->getValue().Total)
+                 return A->getValue().Total > B->getValue().Total;
+               return A->getKey() < B->getKey();
+             });
+
+  static const Type Types[] = {Type::Passed,
+                               Type::Missed,
+                               Type::Analysis,
+                               Type::AnalysisFPCommute,
+                               Type::AnalysisAliasing,
+                               Type::Failure};
+  std::unique_ptr<ToolOutputFile> Out = openOutput();
+  raw_ostream &OS = Out->os();
+  if (CSV) {
+    OS << "Key,Total";
+    for (Type T : Types)
+      OS << ',' << getTypeName(T);
+    OS << ",Hotness\n";
+    for (const StringMapEntry<GroupSummary> *G : Sorted) {
+      OS << G->getKey() << ',' << G->getValue().Total;
+      for (Type T : Types)
+        OS << ',' << G->getValue().Counts[static_cast<unsigned>(T)];
+      OS << ',' << G->getValue().Hotness << '\n';
+    }
+  } else {
+    OS << left_justify("Key", KeyWidth)
+       << formatv(" {0,8} {1,8} {2,8} {3,8} {4,8} {5,12}\n", "Total",
+                  "Passed", "Missed", "Analysis", "Failure", "Hotness");
+    for (const StringMapEntry<GroupSummary> *G : Sorted) {
+      const GroupSummary &S = G->getValue();
+      uint64_t Analysis =
+          S.Counts[static_cast<unsigned>(Type::Analysis)] +
+          S.Counts[static_cast<unsigned>(Type::AnalysisFPCommute)] +
+          S.Counts[static_cast<unsigned>(Type::AnalysisAliasing)];
+      OS << left_justify(G->getKey(), KeyWidth)
+         << formatv(" {0,8} {1,8} {2,8} {3,8} {4,8} {5,12}\n", S.Total,
+                    S.Counts[static_cast<unsigned>(Type::Passed)],
+                    S.Counts[static_cast<unsigned>(Type::Missed)], Analysis,
+                    S.Counts[static_cast<unsigned>(Type::Failure)],
+                    S.Hotness);
+    }
+  }
+  Out->keep();
+}
+
+int main(int argc, const char **argv) {
+  InitLLVM X(argc, argv);
+  ExitOnErr.setBanner("llvm-remarkutil: ");
+  cl::ParseCommandLineOptions(argc, argv,
+                              "Convert and summarize remark files\n");
+
+  if (ConvertSubcommand)
+    convert();
+  else if (SummarySubcommand)
+    summarize();
+  else
+    cl::PrintHelpMessage(false, true);
+  return 0;
+}
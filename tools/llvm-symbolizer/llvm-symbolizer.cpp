@@ -16,6 +16,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/DebugInfo/Symbolize/DIPrinter.h"
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 #include "llvm/Support/COM.h"
@@ -28,6 +29,16 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
+
+#ifdef LLVM_ON_UNIX
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 using namespace llvm;
 using namespace symbolize;
@@ -90,6 +101,28 @@ static cl::opt<int> ClPrintSourceContextLines(
 static cl::opt<bool> ClVerbose("verbose", cl::init(false),
                                cl::desc("Print verbose line info"));
 
+static cl::opt<bool>
+    ClServer("server", cl::init(false),
+             cl::desc("Run as a long-lived server: each request line may hold "
+                      "several addresses, and code is symbolized from an "
+                      "address index of each module"));
+
+static cl::opt<std::string>
+    ClSocket("socket", cl::init(""),
+             cl::desc("In server mode, take requests on this Unix domain "
+                      "socket instead of standard input"));
+
+static cl::opt<bool> ClAddressIndex(
+    "address-index", cl::init(false),
+    cl::desc("Build an index of the address ranges of each module on first "
+             "use and symbolize code from it (default in server mode)"));
+
+static cl::opt<bool> ClPersistAddressIndex(
+    "persist-address-index", cl::init(false),
+    cl::desc("Save the address index of each module next to it, as "
+             "<module>.llvm-symidx, and reuse it while the module is "
+             "unchanged"));
+
 template<typename T>
 static bool error(Expected<T> &ResOrErr) {
   if (ResOrErr)
@@ -100,7 +133,8 @@ static bool error(Expected<T> &ResOrErr) {
 }
 
 static bool parseCommand(StringRef InputString, bool &IsData,
-                         std::string &ModuleName, uint64_t &ModuleOffset) {
+                         std::string &ModuleName,
+                         std::vector<uint64_t> &ModuleOffsets) {
   const char kDelimiters[] = " \n\r";
   ModuleName = "";
   if (InputString.consume_front("CODE ")) {
@@ -131,10 +165,166 @@ static bool parseCommand(StringRef InputString, bool &IsData,
   } else {
     ModuleName = ClBinaryName;
   }
-  // Skip delimiters and parse module offset.
-  pos += strspn(pos, kDelimiters);
-  int offset_length = strcspn(pos, kDelimiters);
-  return !StringRef(pos, offset_length).getAsInteger(0, ModuleOffset);
+  // Skip delimiters and parse module offset. In server mode, a request may
+  // carry any number of them.
+  ModuleOffsets.clear();
+  const char *end = InputString.end();
+  do {
+    pos += strspn(pos, kDelimiters);
+    int offset_length = strcspn(pos, kDelimiters);
+    uint64_t ModuleOffset;
+    if (StringRef(pos, offset_length).getAsInteger(0, ModuleOffset))
+      return false;
+    ModuleOffsets.push_back(ModuleOffset);
+    pos += offset_length;
+    pos += strspn(pos, kDelimiters);
+  } while (ClServer && pos < end && *pos);
+  return true;
+}
+
+static void symbolizeInput(StringRef InputString, LLVMSymbolizer &Symbolizer,
+                           DIPrinter &Printer, raw_ostream &OS) {
+  bool IsData = false;
+  std::string ModuleName;
+  std::vector<uint64_t> ModuleOffsets;
+  if (!parseCommand(InputString, IsData, ModuleName, ModuleOffsets)) {
+    OS << InputString;
+    return;
+  }
+
+  for (uint64_t ModuleOffset : ModuleOffsets) {
+    if (ClPrintAddress) {
+      OS << "0x";
+      OS.write_hex(ModuleOffset);
+      StringRef Delimiter = ClPrettyPrint ? ": " : "\n";
+      OS << Delimiter;
+    }
+    if (IsData) {
+      auto ResOrErr = Symbolizer.symbolizeData(ModuleName, ModuleOffset);
+      Printer << (error(ResOrErr) ? DIGlobal() : ResOrErr.get());
+    } else if (ClPrintInlining) {
+      auto ResOrErr =
+          Symbolizer.symbolizeInlinedCode(ModuleName, ModuleOffset, ClDwpName);
+      Printer << (error(ResOrErr) ? DIInliningInfo()
+                                             : ResOrErr.get());
+    } else {
+      auto ResOrErr =
+          Symbolizer.symbolizeCode(ModuleName, ModuleOffset, ClDwpName);
+      Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get());
+    }
+    OS << "\n";
+  }
+}
+
+/// Read a line of any length from \p F, including its newline.
+static bool readLine(FILE *F, std::string &Line) {
+  Line.clear();
+  char Buffer[1024];
+  while (fgets(Buffer, sizeof(Buffer), F)) {
+    Line += Buffer;
+    if (!Line.empty() && Line.back() == '\n')
+      break;
+  }
+  return !Line.empty();
+}
+
+/// Serve requests from the clients of a Unix domain socket at \p Path, until
+/// the process is killed. Clients are served in turn, a line at a time, so
+/// that a slow client doesn't hold up the others.
+static int serveSocket(StringRef Path, LLVMSymbolizer &Symbolizer) {
+#ifdef LLVM_ON_UNIX
+  sockaddr_un Addr;
+  memset(&Addr, 0, sizeof(Addr));
+  Addr.sun_family = AF_UNIX;
+  if (Path.size() >= sizeof(Addr.sun_path)) {
+    errs() << "llvm-symbolizer: socket path too long: " << Path << "\n";
+    return 1;
+  }
+  memcpy(Addr.sun_path, Path.data(), Path.size());
+
+  int ListenFD = socket(AF_UNIX, SOCK_STREAM, 0);
+  sys::fs::remove(Path);
+  if (ListenFD < 0 ||
+      bind(ListenFD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) ||
+      listen(ListenFD, SOMAXCONN)) {
+    errs() << "llvm-symbolizer: cannot listen on " << Path << ": "
+           << strerror(errno) << "\n";
+    return 1;
+  }
+  // A client that goes away shows up as a write error on its stream.
+  signal(SIGPIPE, SIG_IGN);
+
+  struct Client {
+    int FD;
+    std::string Input;
+    std::unique_ptr<raw_fd_ostream> OS;
+    std::unique_ptr<DIPrinter> Printer;
+  };
+  std::vector<std::unique_ptr<Client>> Clients;
+  std::vector<pollfd> PollFDs;
+  while (true) {
+    PollFDs.clear();
+    PollFDs.push_back({ListenFD, POLLIN, 0});
+    for (const auto &C : Clients)
+      PollFDs.push_back({C->FD, POLLIN, 0});
+    if (poll(PollFDs.data(), PollFDs.size(), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      errs() << "llvm-symbolizer: poll: " << strerror(errno) << "\n";
+      return 1;
+    }
+
+    for (size_t I = Clients.size(); I != 0; --I) {
+      if (!PollFDs[I].revents)
+        continue;
+      Client &C = *Clients[I - 1];
+      char Buffer[4096];
+      ssize_t N = read(C.FD, Buffer, sizeof(Buffer));
+      if (N < 0 && errno == EINTR)
+        continue;
+      bool Closed = N <= 0;
+      if (!Closed)
+        C.Input.append(Buffer, N);
+      // parseCommand wants a null-terminated line.
+      size_t Start = 0, End;
+      while ((End = C.Input.find('\n', Start)) != std::string::npos) {
+        std::string Line = C.Input.substr(Start, End + 1 - Start);
+        symbolizeInput(Line, Symbolizer, *C.Printer, *C.OS);
+        Start = End + 1;
+      }
+      C.Input.erase(0, Start);
+      if (Closed && !C.Input.empty())
+        symbolizeInput(C.Input, Symbolizer, *C.Printer, *C.OS);
+      C.OS->flush();
+      if (C.OS->has_error()) {
+        C.OS->clear_error();
+        Closed = true;
+      }
+      if (Closed) {
+        C.Printer.reset();
+        C.OS.reset();
+        close(C.FD);
+        Clients.erase(Clients.begin() + (I - 1));
+      }
+    }
+
+    if (PollFDs[0].revents & POLLIN) {
+      int FD = accept(ListenFD, nullptr, nullptr);
+      if (FD >= 0) {
+        auto C = llvm::make_unique<Client>();
+        C->FD = FD;
+        C->OS = llvm::make_unique<raw_fd_ostream>(FD, /*shouldClose=*/false);
+        C->Printer = llvm::make_unique<DIPrinter>(
+            *C->OS, ClPrintFunctions != FunctionNameKind::None, ClPrettyPrint,
+            ClPrintSourceContextLines, ClVerbose);
+        Clients.push_back(std::move(C));
+      }
+    }
+  }
+#else
+  errs() << "llvm-symbolizer: -socket is not supported on this platform\n";
+  return 1;
+#endif
 }
 
 int main(int argc, char **argv) {
@@ -145,6 +335,10 @@ int main(int argc, char **argv) {
   cl::ParseCommandLineOptions(argc, argv, "llvm-symbolizer\n");
   LLVMSymbolizer::Options Opts(ClPrintFunctions, ClUseSymbolTable, ClDemangle,
                                ClUseRelativeAddress, ClDefaultArch);
+  Opts.UseAddressIndex = ClAddressIndex.getNumOccurrences()
+                             ? bool(ClAddressIndex)
+                             : ClServer || ClPersistAddressIndex;
+  Opts.PersistAddressIndex = ClPersistAddressIndex;
 
   for (const auto &hint : ClDsymHint) {
     if (sys::path::extension(hint) == ".dSYM") {
@@ -156,45 +350,20 @@ int main(int argc, char **argv) {
   }
   LLVMSymbolizer Symbolizer(Opts);
 
+  if (!ClSocket.empty()) {
+    if (!ClServer) {
+      errs() << "llvm-symbolizer: -socket requires -server\n";
+      return 1;
+    }
+    return serveSocket(ClSocket, Symbolizer);
+  }
+
   DIPrinter Printer(outs(), ClPrintFunctions != FunctionNameKind::None,
                     ClPrettyPrint, ClPrintSourceContextLines, ClVerbose);
 
-  const int kMaxInputStringLength = 1024;
-  char InputString[kMaxInputStringLength];
-
-  while (true) {
-    if (!fgets(InputString, sizeof(InputString), stdin))
-      break;
-
-    bool IsData = false;
-    std::string ModuleName;
-    uint64_t ModuleOffset = 0;
-    if (!parseCommand(StringRef(InputString), IsData, ModuleName,
-                      ModuleOffset)) {
-      outs() << InputString;
-      continue;
-    }
-
-    if (ClPrintAddress) {
-      outs() << "0x";
-      outs().write_hex(ModuleOffset);
-      StringRef Delimiter = ClPrettyPrint ? ": " : "\n";
-      outs() << Delimiter;
-    }
-    if (IsData) {
-      auto ResOrErr = Symbolizer.symbolizeData(ModuleName, ModuleOffset);
-      Printer << (error(ResOrErr) ? DIGlobal() : ResOrErr.get());
-    } else if (ClPrintInlining) {
-      auto ResOrErr =
-          Symbolizer.symbolizeInlinedCode(ModuleName, ModuleOffset, ClDwpName);
-      Printer << (error(ResOrErr) ? DIInliningInfo()
-                                             : ResOrErr.get());
-    } else {
-      auto ResOrErr =
-          Symbolizer.symbolizeCode(ModuleName, ModuleOffset, ClDwpName);
-      Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get());
-    }
-    outs() << "\n";
+  std::string InputString;
+  while (readLine(stdin, InputString)) {
+    symbolizeInput(InputString, Symbolizer, Printer, outs());
     outs().flush();
   }
 
@@ -39,6 +39,7 @@
 #include "llvm/LinkAllIR.h"
 #include "llvm/LinkAllPasses.h"
 #include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Remarks/BinaryRemarkWriter.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Host.h"
@@ -258,9 +259,20 @@ static cl::opt<unsigned> PassRemarksHotnessThreshold(
 
 static cl::opt<std::string>
     RemarksFilename("pass-remarks-output",
-                    cl::desc("YAML output filename for pass remarks"),
+                    cl::desc("Output filename for pass remarks"),
                     cl::value_desc("filename"));
 
+namespace {
+enum class RemarksFormatKind { YAML, Binary };
+} // end anonymous namespace
+
+static cl::opt<RemarksFormatKind> RemarksFormat(
+    "pass-remarks-format", cl::desc("The format of the pass remarks file"),
+    cl::init(RemarksFormatKind::YAML),
+    cl::values(clEnumValN(RemarksFormatKind::YAML, "yaml", "YAML (default)"),
+               clEnumValN(RemarksFormatKind::Binary, "binary",
+                          "Compact binary format, see llvm-remarkutil")));
+
 class OptCustomPassManager : public legacy::PassManager {
 public:
   using super = legacy::PassManager;
@@ -482,8 +494,12 @@ int main(int argc, char **argv) {
       errs() << EC.message() << '\n';
       return 1;
     }
-    Context.setDiagnosticsOutputFile(
-        llvm::make_unique<yaml::Output>(OptRemarkFile->os()));
+    if (RemarksFormat == RemarksFormatKind::Binary)
+      Context.setDiagnosticsBinaryOutput(
+          llvm::make_unique<remarks::BinaryRemarkWriter>(OptRemarkFile->os()));
+    else
+      Context.setDiagnosticsOutputFile(
+          llvm::make_unique<yaml::Output>(OptRemarkFile->os()));
   }
 
   // Load the input module...
@@ -11,6 +11,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Bitcode/BitstreamWriter.h"
 #include "gtest/gtest.h"
+#include <chrono>
 
 using namespace llvm;
 
@@ -148,4 +149,103 @@ TEST(BitstreamReaderTest, shortRead) {
   }
 }
 
+static std::vector<uint64_t> makeVBRValues(size_t Count, unsigned NumBits) {
+  std::vector<uint64_t> Values;
+  for (size_t I = 0; I != Count; ++I) {
+    // Mostly values that fit in one chunk, some that need several.
+    uint64_t V = I * 0x9e3779b97f4a7c15ULL;
+    uint64_t ChunkMask = (uint64_t(1) << (NumBits - 1)) - 1;
+    Values.push_back(I % 7 == 6 ? V >> (I % 64) : V & ChunkMask);
+  }
+  return Values;
+}
+
+TEST(BitstreamReaderTest, readVBR64Array) {
+  for (unsigned NumBits : {2, 3, 6, 8, 17, 32})
+    for (unsigned Skew : {0, 1, 5, 31})
+      for (size_t Count : {0, 1, 10, 11, 100, 1000}) {
+        std::vector<uint64_t> Values = makeVBRValues(Count, NumBits);
+        SmallVector<char, 1> Buffer;
+        {
+          BitstreamWriter Stream(Buffer);
+          if (Skew)
+            Stream.Emit(0, Skew);
+          for (uint64_t V : Values)
+            Stream.EmitVBR64(V, NumBits);
+          Stream.Emit(0x5a, 8);
+          Stream.FlushToWord();
+        }
+
+        SimpleBitstreamCursor Cursor(
+            ArrayRef<uint8_t>((const uint8_t *)Buffer.begin(), Buffer.size()));
+        if (Skew)
+          Cursor.Read(Skew);
+        SmallVector<uint64_t, 8> Out = {42};
+        Cursor.readVBR64Array(NumBits, Count, Out);
+        ASSERT_EQ(Count + 1, Out.size());
+        EXPECT_EQ(42u, Out[0]);
+        for (size_t I = 0; I != Count; ++I)
+          EXPECT_EQ(Values[I], Out[I + 1]);
+        EXPECT_EQ(0x5au, Cursor.Read(8));
+      }
+}
+
+TEST(BitstreamReaderTest, readUnabbrevRecord) {
+  std::vector<uint64_t> Values = makeVBRValues(500, 6);
+  SmallVector<char, 1> Buffer;
+  {
+    BitstreamWriter Stream(Buffer);
+    Stream.EnterSubblock(bitc::FIRST_APPLICATION_BLOCKID, 3);
+    Stream.EmitRecord(1, Values);
+    Stream.ExitBlock();
+  }
+
+  BitstreamCursor Stream(
+      ArrayRef<uint8_t>((const uint8_t *)Buffer.begin(), Buffer.size()));
+  BitstreamEntry Entry = Stream.advance();
+  ASSERT_EQ(BitstreamEntry::SubBlock, Entry.Kind);
+  ASSERT_FALSE(Stream.EnterSubBlock(bitc::FIRST_APPLICATION_BLOCKID));
+  Entry = Stream.advance();
+  ASSERT_EQ(BitstreamEntry::Record, Entry.Kind);
+  SmallVector<uint64_t, 1> Record;
+  ASSERT_EQ(1u, Stream.readRecord(Entry.ID, Record));
+  EXPECT_EQ(Values, std::vector<uint64_t>(Record.begin(), Record.end()));
+}
+
+// Compare reading an array of VBRs in bulk with reading them one at a time.
+TEST(BitstreamReaderTest, readVBR64ArrayThroughput) {
+  const size_t Count = 1 << 20;
+  std::vector<uint64_t> Values = makeVBRValues(Count, 6);
+  SmallVector<char, 1> Buffer;
+  {
+    BitstreamWriter Stream(Buffer);
+    for (uint64_t V : Values)
+      Stream.EmitVBR64(V, 6);
+    Stream.FlushToWord();
+  }
+  ArrayRef<uint8_t> Bytes((const uint8_t *)Buffer.begin(), Buffer.size());
+  typedef std::chrono::steady_clock Clock;
+
+  Clock::time_point Start = Clock::now();
+  SmallVector<uint64_t, 1> Scalar;
+  SimpleBitstreamCursor ScalarCursor(Bytes);
+  for (size_t I = 0; I != Count; ++I)
+    Scalar.push_back(ScalarCursor.ReadVBR64(6));
+  Clock::time_point Mid = Clock::now();
+  SmallVector<uint64_t, 1> Bulk;
+  SimpleBitstreamCursor BulkCursor(Bytes);
+  BulkCursor.readVBR64Array(6, Count, Bulk);
+  Clock::time_point End = Clock::now();
+  EXPECT_EQ(Scalar, Bulk);
+
+  // Report the times in the test's XML output.
+  typedef std::chrono::microseconds US;
+  testing::Test::RecordProperty(
+      "ScalarMicroseconds",
+      int(std::chrono::duration_cast<US>(Mid - Start).count()));
+  testing::Test::RecordProperty(
+      "ArrayMicroseconds",
+      int(std::chrono::duration_cast<US>(End - Mid).count()));
+}
+
 } // end anonymous namespace
@@ -85,14 +85,16 @@ std::unique_ptr<BogusTargetMachine> createTargetMachine() {
 }
 
 std::unique_ptr<MachineFunction> createMachineFunction() {
-  LLVMContext Ctx;
-  Module M("Module", Ctx);
+  // The function, the target machine and the MachineModuleInfo must outlive
+  // the MachineFunction.
+  static LLVMContext Ctx;
+  static Module M("Module", Ctx);
   auto Type = FunctionType::get(Type::getVoidTy(Ctx), false);
   auto F = Function::Create(Type, GlobalValue::ExternalLinkage, "Test", &M);
 
-  auto TM = createTargetMachine();
+  static auto TM = createTargetMachine();
   unsigned FunctionNum = 42;
-  MachineModuleInfo MMI(TM.get());
+  static MachineModuleInfo MMI(TM.get());
   const TargetSubtargetInfo &STI = *TM->getSubtargetImpl(*F);
 
   return llvm::make_unique<MachineFunction>(*F, *TM, STI, FunctionNum, MMI);
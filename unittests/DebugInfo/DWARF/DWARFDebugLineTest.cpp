@@ -286,6 +286,39 @@ TEST_P(DebugLineParameterisedFixture, GetOrParseLineTableValidTable) {
   // correctly.
 }
 
+TEST_F(DebugLineBasicFixture, InsertedLineTableIsReturned) {
+  if (!setupGenerator())
+    return;
+
+  LineTable &LT = Gen->addLineTable();
+  LT.addExtendedOpcode(9, DW_LNE_set_address, {{0xadd4e55, LineTable::Quad}});
+  LT.addStandardOpcode(DW_LNS_copy, {});
+  LT.addExtendedOpcode(1, DW_LNE_end_sequence, {});
+
+  generate();
+
+  DWARFDebugLine::LineTable Parsed;
+  uint32_t Offset = 0;
+  ASSERT_FALSE(
+      Parsed.parse(LineData, &Offset, *Context, nullptr, RecordRecoverable));
+  EXPECT_FALSE(Recoverable);
+  Line.insertLineTable(0, std::move(Parsed));
+
+  // The inserted table is found without parsing the section again, and
+  // inserting another table at the same offset does not replace it.
+  const DWARFDebugLine::LineTable *Inserted = Line.getLineTable(0);
+  ASSERT_NE(Inserted, nullptr);
+  EXPECT_EQ(Inserted->Rows.size(), 2u);
+  Line.insertLineTable(0, DWARFDebugLine::LineTable());
+  EXPECT_EQ(Line.getLineTable(0), Inserted);
+  EXPECT_EQ(Line.getLineTable(0)->Rows.size(), 2u);
+
+  auto ExpectedLineTable = Line.getOrParseLineTable(LineData, 0, *Context,
+                                                    nullptr, RecordRecoverable);
+  ASSERT_TRUE(ExpectedLineTable.operator bool());
+  EXPECT_EQ(*ExpectedLineTable, Inserted);
+}
+
 TEST_F(DebugLineBasicFixture, ErrorForReservedLength) {
   if (!setupGenerator())
     return;
@@ -0,0 +1,134 @@
+//===- ConcurrentUniquingTest.cpp - Concurrent context uniquing tests -----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/Support/thread.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+using namespace llvm;
+
+namespace {
+
+TEST(ConcurrentUniquingTest, enableConcurrentUniquing) {
+  LLVMContext Context;
+  EXPECT_FALSE(Context.isConcurrentUniquing());
+  Context.enableConcurrentUniquing();
+  EXPECT_TRUE(Context.isConcurrentUniquing());
+  Context.disableConcurrentUniquing();
+  EXPECT_FALSE(Context.isConcurrentUniquing());
+}
+
+#if LLVM_ENABLE_THREADS
+
+const unsigned NumThreads = 8;
+const unsigned NumValues = 20000;
+
+/// Run \p Fn(ThreadIndex) on NumThreads threads and return the elapsed time in
+/// seconds.
+template <typename FnTy> double runOnThreads(FnTy Fn) {
+  auto Start = std::chrono::steady_clock::now();
+  std::vector<llvm::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&Fn, T] { Fn(T); });
+  for (auto &Thread : Threads)
+    Thread.join();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       Start)
+      .count();
+}
+
+TEST(ConcurrentUniquingTest, Constants) {
+  LLVMContext Context;
+  Context.enableConcurrentUniquing();
+
+  // Every thread creates the same values, in a different order, so that the
+  // threads race on inserting each of them.
+  std::vector<std::vector<ConstantInt *>> Ints(NumThreads);
+  std::vector<std::vector<ConstantFP *>> FPs(NumThreads);
+  double Seconds = runOnThreads([&](unsigned T) {
+    Ints[T].resize(NumValues);
+    FPs[T].resize(NumValues);
+    for (unsigned I = 0; I != NumValues; ++I) {
+      unsigned V = (I + T * (NumValues / NumThreads)) % NumValues;
+      // Odd widths exercise IntegerType creation as well.
+      Ints[T][V] = ConstantInt::get(Context, APInt(33 + V % 7, V));
+      FPs[T][V] = ConstantFP::get(Context, APFloat(double(V)));
+    }
+  });
+
+  for (unsigned T = 1; T != NumThreads; ++T) {
+    EXPECT_EQ(Ints[0], Ints[T]);
+    EXPECT_EQ(FPs[0], FPs[T]);
+  }
+  for (unsigned I = 0; I != NumValues; ++I) {
+    EXPECT_EQ(I, Ints[0][I]->getZExtValue());
+    EXPECT_EQ(33 + I % 7, Ints[0][I]->getBitWidth());
+  }
+
+  // Report the throughput in the test's XML output.
+  testing::Test::RecordProperty(
+      "ConstantsPerSecond",
+      int(2 * NumThreads * NumValues / std::max(Seconds, 1e-6)));
+}
+
+TEST(ConcurrentUniquingTest, Metadata) {
+  LLVMContext Context;
+  Context.enableConcurrentUniquing();
+
+  std::vector<std::vector<MDNode *>> Nodes(NumThreads);
+  double Seconds = runOnThreads([&](unsigned T) {
+    Nodes[T].resize(NumValues);
+    for (unsigned I = 0; I != NumValues; ++I) {
+      unsigned V = (I + T * (NumValues / NumThreads)) % NumValues;
+      Metadata *Ops[] = {MDString::get(Context, "node" + std::to_string(V)),
+                         ConstantAsMetadata::get(ConstantInt::get(
+                             Type::getInt32Ty(Context), V))};
+      Nodes[T][V] = MDTuple::get(Context, Ops);
+    }
+  });
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Nodes[0], Nodes[T]);
+  for (unsigned I = 0; I != NumValues; ++I)
+    EXPECT_EQ("node" + std::to_string(I),
+              cast<MDString>(Nodes[0][I]->getOperand(0))->getString());
+
+  testing::Test::RecordProperty(
+      "NodesPerSecond", int(NumThreads * NumValues / std::max(Seconds, 1e-6)));
+}
+
+TEST(ConcurrentUniquingTest, Types) {
+  LLVMContext Context;
+  Context.enableConcurrentUniquing();
+
+  std::vector<std::vector<Type *>> Types(NumThreads);
+  runOnThreads([&](unsigned T) {
+    for (unsigned I = 0; I != 256; ++I) {
+      Type *Int = IntegerType::get(Context, 1 + I);
+      Type *Ptr = Int->getPointerTo();
+      Types[T].push_back(ArrayType::get(Ptr, I));
+      Types[T].push_back(VectorType::get(Int, 1 + I % 16));
+      Types[T].push_back(StructType::get(Context, {Int, Ptr}));
+      Types[T].push_back(FunctionType::get(Ptr, {Int}, false));
+    }
+  });
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Types[0], Types[T]);
+}
+
+#endif // LLVM_ENABLE_THREADS
+
+} // end namespace
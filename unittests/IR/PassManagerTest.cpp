@@ -12,8 +12,12 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/ParallelFunctionPassAdaptor.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
+#include <atomic>
+#include <list>
+#include <mutex>
 
 using namespace llvm;
 
@@ -772,4 +776,94 @@ TEST_F(PassManagerTest, IndirectAnalysisInvalidation) {
   // three functions.
   EXPECT_EQ(3 * 4 * 3, FunctionCount);
 }
+
+// Like TestFunctionPass, but safe to run on several threads at once. Returns
+// PreservedAnalyses::none() for the function named InvalidateName.
+struct TestParallelFunctionPass : PassInfoMixin<TestParallelFunctionPass> {
+  TestParallelFunctionPass(std::atomic<int> &RunCount,
+                           std::atomic<int> &AnalyzedInstrCount,
+                           std::atomic<int> &AnalyzedFunctionCount,
+                           StringRef InvalidateName)
+      : RunCount(RunCount), AnalyzedInstrCount(AnalyzedInstrCount),
+        AnalyzedFunctionCount(AnalyzedFunctionCount),
+        InvalidateName(InvalidateName) {}
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM) {
+    ++RunCount;
+
+    const ModuleAnalysisManager &MAM =
+        AM.getResult<ModuleAnalysisManagerFunctionProxy>(F).getManager();
+    if (TestModuleAnalysis::Result *TMA =
+            MAM.getCachedResult<TestModuleAnalysis>(*F.getParent()))
+      AnalyzedFunctionCount += TMA->FunctionCount;
+
+    AnalyzedInstrCount += AM.getResult<TestFunctionAnalysis>(F).InstructionCount;
+
+    return F.getName() == InvalidateName ? PreservedAnalyses::none()
+                                         : PreservedAnalyses::all();
+  }
+
+  std::atomic<int> &RunCount;
+  std::atomic<int> &AnalyzedInstrCount;
+  std::atomic<int> &AnalyzedFunctionCount;
+  StringRef InvalidateName;
+};
+
+TEST_F(PassManagerTest, ParallelFunctionPassAdaptor) {
+  FunctionAnalysisManager FAM;
+  int FunctionAnalysisRuns = 0;
+  FAM.registerPass([&] { return TestFunctionAnalysis(FunctionAnalysisRuns); });
+
+  ModuleAnalysisManager MAM;
+  int ModuleAnalysisRuns = 0;
+  MAM.registerPass([&] { return TestModuleAnalysis(ModuleAnalysisRuns); });
+  MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+  FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+
+  // Each worker registers its own instance of the function analysis.
+  std::mutex WorkerMutex;
+  std::list<int> WorkerAnalysisRuns;
+  auto RegisterAnalyses = [&](FunctionAnalysisManager &WorkerFAM) {
+    std::lock_guard<std::mutex> Lock(WorkerMutex);
+    WorkerAnalysisRuns.push_back(0);
+    int &Runs = WorkerAnalysisRuns.back();
+    WorkerFAM.registerPass([&Runs] { return TestFunctionAnalysis(Runs); });
+  };
+
+  std::atomic<int> RunCount(0), InstrCount(0), FunctionCount(0);
+  auto CreatePass = [&] {
+    FunctionPassManager FPM;
+    FPM.addPass(
+        TestParallelFunctionPass(RunCount, InstrCount, FunctionCount, "f"));
+    return FPM;
+  };
+
+  ModulePassManager MPM;
+  // Cache the module analysis and the outer function analyses, then run the
+  // parallel adaptor and require the function analyses again.
+  MPM.addPass(RequireAnalysisPass<TestModuleAnalysis, Module>());
+  MPM.addPass(createModuleToFunctionPassAdaptor(
+      RequireAnalysisPass<TestFunctionAnalysis, Function>()));
+  MPM.addPass(ParallelModuleToFunctionPassAdaptor<FunctionPassManager>(
+      CreatePass, RegisterAnalyses, 2));
+  MPM.addPass(createModuleToFunctionPassAdaptor(
+      RequireAnalysisPass<TestFunctionAnalysis, Function>()));
+  MPM.run(*M, MAM);
+
+  EXPECT_EQ(3, RunCount);
+  EXPECT_EQ(1, ModuleAnalysisRuns);
+  // Every function was analyzed once on a worker.
+  int TotalWorkerRuns = 0;
+  for (int Runs : WorkerAnalysisRuns)
+    TotalWorkerRuns += Runs;
+  EXPECT_EQ(3, TotalWorkerRuns);
+  // The outer analysis ran for each function, and again for the one function
+  // whose analyses were invalidated.
+  EXPECT_EQ(4, FunctionAnalysisRuns);
+  // There are five instructions in the module and three functions, seen once
+  // from each function.
+  EXPECT_EQ(5, InstrCount);
+  EXPECT_EQ(3 * 3, FunctionCount);
+  EXPECT_FALSE(Context.isConcurrentUniquing());
+}
 }
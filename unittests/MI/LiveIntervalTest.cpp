@@ -2,7 +2,9 @@
 #include "llvm/CodeGen/LiveIntervals.h"
 #include "llvm/CodeGen/MIRParser/MIRParser.h"
 #include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/TargetInstrInfo.h"
 #include "llvm/CodeGen/TargetRegisterInfo.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -420,6 +422,56 @@ TEST(LiveIntervalTest, DeadSubRegMoveUp) {
   });
 }
 
+TEST(LiveIntervalTest, MoveToOtherBlock) {
+  liveIntervalTest(R"MIR(
+    successors: %bb.1
+    %0 = IMPLICIT_DEF
+    S_NOP 0, implicit %0
+    S_BRANCH %bb.1
+  bb.1:
+    S_NOP 0
+)MIR", [](MachineFunction &MF, LiveIntervals &LIS) {
+    MachineInstr &Use = getMI(MF, 1, 0);
+    unsigned Reg = Use.getOperand(1).getReg();
+    MachineBasicBlock &MBB1 = *MF.getBlockNumbered(1);
+    MBB1.splice(MBB1.begin(), Use.getParent(), Use.getIterator());
+    LIS.handleMove(Use);
+    EXPECT_TRUE(LIS.getInterval(Reg).liveAt(LIS.getMBBStartIdx(&MBB1)));
+  });
+}
+
+TEST(LiveIntervalTest, InsertUse) {
+  liveIntervalTest(R"MIR(
+    %0 = IMPLICIT_DEF
+    S_NOP 0
+    S_NOP 0
+)MIR", [](MachineFunction &MF, LiveIntervals &LIS) {
+    unsigned Reg = getMI(MF, 0, 0).getOperand(0).getReg();
+    MachineInstr &Last = getMI(MF, 2, 0);
+    const TargetInstrInfo &TII = *MF.getSubtarget().getInstrInfo();
+    MachineInstr *Use = BuildMI(*Last.getParent(), Last, DebugLoc(),
+                                TII.get(TargetOpcode::KILL))
+                            .addReg(Reg);
+    LIS.handleInsert(*Use);
+    EXPECT_TRUE(LIS.getInterval(Reg).liveAt(
+        LIS.getInstructionIndex(getMI(MF, 1, 0))));
+  });
+}
+
+TEST(LiveIntervalTest, EraseUse) {
+  liveIntervalTest(R"MIR(
+    %0 = IMPLICIT_DEF
+    S_NOP 0, implicit %0
+    S_NOP 0
+    S_NOP 0, implicit %0
+)MIR", [](MachineFunction &MF, LiveIntervals &LIS) {
+    unsigned Reg = getMI(MF, 0, 0).getOperand(0).getReg();
+    LIS.eraseInstr(getMI(MF, 3, 0));
+    EXPECT_FALSE(LIS.getInterval(Reg).liveAt(
+        LIS.getInstructionIndex(getMI(MF, 2, 0))));
+  });
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   initLLVM();
@@ -0,0 +1,140 @@
+//===- ArchiveTest.cpp - Tests for Archive.cpp ----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Object/Archive.h"
+#include "llvm/Object/ArchiveWriter.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace object;
+
+namespace {
+
+class ArchiveSymbolIndexTest
+    : public ::testing::TestWithParam<std::pair<Archive::Kind, bool>> {
+protected:
+  void SetUp() override {
+    Names.push_back("foo");
+    Names.push_back("bar");
+    Names.push_back("baz");
+    for (unsigned I = 0; I != 1000; ++I)
+      Names.push_back("sym" + std::to_string(I));
+  }
+
+  // Write an archive whose first member defines foo and bar, and whose
+  // second member defines baz, foo again, and many more symbols.
+  std::unique_ptr<MemoryBuffer> writeArchive() {
+    Archive::Kind Kind = GetParam().first;
+    bool WriteIndex = GetParam().second;
+
+    std::vector<NewArchiveMember> Members(2);
+    Members[0].Buf = MemoryBuffer::getMemBuffer("first member\n", "a.o");
+    Members[0].MemberName = "a.o";
+    Members[0].Symbols = std::vector<StringRef>{Names[0], Names[1]};
+    Members[1].Buf = MemoryBuffer::getMemBuffer("second member\n", "b.o");
+    Members[1].MemberName = "b.o";
+    Members[1].Symbols = std::vector<StringRef>{Names[2], Names[0]};
+    for (unsigned I = 3, E = Names.size(); I != E; ++I)
+      Members[1].Symbols->push_back(Names[I]);
+
+    SmallString<128> Path;
+    std::error_code EC =
+        sys::fs::createTemporaryFile("ArchiveTest", "a", Path);
+    EXPECT_FALSE(EC);
+    Error Err = llvm::writeArchive(Path, Members, true, Kind, true, false,
+                                   nullptr, WriteIndex);
+    EXPECT_FALSE(bool(Err));
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+        MemoryBuffer::getFileAsStream(Path);
+    sys::fs::remove(Path);
+    EXPECT_TRUE(bool(BufOrErr));
+    return std::move(*BufOrErr);
+  }
+
+  static std::unique_ptr<Archive> readArchive(const MemoryBuffer &Buf) {
+    Expected<std::unique_ptr<Archive>> ArchiveOrErr =
+        Archive::create(Buf.getMemBufferRef());
+    EXPECT_TRUE(bool(ArchiveOrErr));
+    return std::move(*ArchiveOrErr);
+  }
+
+  static StringRef getMemberName(const Archive &A, StringRef Symbol) {
+    Expected<Optional<Archive::Child>> ChildOrErr = A.findSym(Symbol);
+    EXPECT_TRUE(bool(ChildOrErr));
+    if (!*ChildOrErr)
+      return "";
+    Expected<StringRef> NameOrErr = (*ChildOrErr)->getName();
+    EXPECT_TRUE(bool(NameOrErr));
+    return *NameOrErr;
+  }
+
+  std::vector<std::string> Names;
+};
+
+TEST_P(ArchiveSymbolIndexTest, FindSymbol) {
+  std::unique_ptr<MemoryBuffer> Buf = writeArchive();
+  std::unique_ptr<Archive> A = readArchive(*Buf);
+  EXPECT_EQ(GetParam().second, A->hasSymbolIndex());
+  EXPECT_EQ(Names.size() + 1, A->getNumberOfSymbols());
+
+  // The index member is not a child.
+  unsigned NumChildren = 0;
+  Error Err = Error::success();
+  for (const Archive::Child &C : A->children(Err)) {
+    (void)C;
+    ++NumChildren;
+  }
+  EXPECT_FALSE(bool(Err));
+  EXPECT_EQ(2U, NumChildren);
+
+  Optional<Archive::Symbol> Foo = A->findSymbol("foo");
+  ASSERT_TRUE(bool(Foo));
+  EXPECT_EQ("foo", Foo->getName());
+  EXPECT_EQ("a.o", getMemberName(*A, "foo"));
+  EXPECT_EQ("a.o", getMemberName(*A, "bar"));
+  EXPECT_EQ("b.o", getMemberName(*A, "baz"));
+  for (unsigned I = 3, E = Names.size(); I != E; ++I)
+    EXPECT_EQ("b.o", getMemberName(*A, Names[I]));
+
+  EXPECT_FALSE(A->findSymbol("fo"));
+  EXPECT_FALSE(A->findSymbol("fooo"));
+  EXPECT_FALSE(A->findSymbol("sym1000"));
+  EXPECT_FALSE(A->findSymbol(""));
+}
+
+TEST_P(ArchiveSymbolIndexTest, StaleIndex) {
+  std::unique_ptr<MemoryBuffer> Buf = writeArchive();
+
+  // Rename bar to bat in the symbol table, so that an index stored in the
+  // archive no longer matches it.
+  std::string Contents = Buf->getBuffer();
+  size_t Pos = Contents.find(StringRef("bar\0", 4));
+  ASSERT_NE(std::string::npos, Pos);
+  Contents[Pos + 2] = 't';
+  std::unique_ptr<MemoryBuffer> Changed =
+      MemoryBuffer::getMemBuffer(Contents, "", false);
+
+  std::unique_ptr<Archive> A = readArchive(*Changed);
+  EXPECT_EQ(GetParam().second, A->hasSymbolIndex());
+  EXPECT_FALSE(A->findSymbol("bar"));
+  EXPECT_EQ("a.o", getMemberName(*A, "bat"));
+  EXPECT_EQ("a.o", getMemberName(*A, "foo"));
+  EXPECT_EQ("b.o", getMemberName(*A, "sym999"));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    ArchiveTest, ArchiveSymbolIndexTest,
+    ::testing::Values(std::make_pair(Archive::K_GNU, false),
+                      std::make_pair(Archive::K_GNU, true),
+                      std::make_pair(Archive::K_BSD, false),
+                      std::make_pair(Archive::K_BSD, true)), );
+
+} // end anonymous namespace
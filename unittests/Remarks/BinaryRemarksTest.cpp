@@ -0,0 +1,161 @@
+//===- unittests/Remarks/BinaryRemarksTest.cpp - Binary remark tests ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Remarks/BinaryRemarkReader.h"
+#include "llvm/Remarks/BinaryRemarkWriter.h"
+#include "llvm/Remarks/YAMLRemarkWriter.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace llvm::remarks;
+
+namespace {
+
+Remark makeRemark(StringRef Function, uint64_t Hotness) {
+  Remark R;
+  R.RemarkType = Type::Missed;
+  R.PassName = "inline";
+  R.RemarkName = "NoDefinition";
+  R.FunctionName = Function;
+  RemarkLocation Loc;
+  Loc.SourceFilePath = "/tmp/s.c";
+  Loc.SourceLine = 5;
+  Loc.SourceColumn = 10;
+  R.Loc = Loc;
+  R.Hotness = Hotness;
+
+  Argument Callee;
+  Callee.Key = "Callee";
+  Callee.Val = "foo";
+  R.Args.push_back(Callee);
+  Argument Str;
+  Str.Key = "String";
+  Str.Val = " will not be inlined into ";
+  R.Args.push_back(Str);
+  Argument Caller;
+  Caller.Key = "Caller";
+  Caller.Val = Function;
+  Loc.SourceLine = 4;
+  Loc.SourceColumn = 0;
+  Caller.Loc = Loc;
+  R.Args.push_back(Caller);
+  return R;
+}
+
+std::string toYAML(const Remark &R) {
+  std::string Str;
+  raw_string_ostream OS(Str);
+  YAMLRemarkWriter(OS).emit(R);
+  return OS.str();
+}
+
+std::string writeRemarks(ArrayRef<Remark> Remarks) {
+  std::string Buf;
+  raw_string_ostream OS(Buf);
+  BinaryRemarkWriter W(OS);
+  for (const Remark &R : Remarks)
+    W.emit(R);
+  return OS.str();
+}
+
+std::vector<std::string> readRemarks(StringRef Buf) {
+  std::vector<std::string> Result;
+  auto ReaderOrErr = BinaryRemarkReader::create(Buf);
+  EXPECT_TRUE(bool(ReaderOrErr));
+  if (!ReaderOrErr) {
+    consumeError(ReaderOrErr.takeError());
+    return Result;
+  }
+  while (true) {
+    Expected<const Remark *> R = (*ReaderOrErr)->next();
+    EXPECT_TRUE(bool(R));
+    if (!R) {
+      consumeError(R.takeError());
+      break;
+    }
+    if (!*R)
+      break;
+    Result.push_back(toYAML(**R));
+  }
+  return Result;
+}
+
+std::string readError(StringRef Buf) {
+  auto ReaderOrErr = BinaryRemarkReader::create(Buf);
+  if (!ReaderOrErr)
+    return toString(ReaderOrErr.takeError());
+  while (true) {
+    Expected<const Remark *> R = (*ReaderOrErr)->next();
+    if (!R)
+      return toString(R.takeError());
+    if (!*R)
+      return "";
+  }
+}
+
+TEST(BinaryRemarksTest, RoundTrip) {
+  Remark Plain;
+  Plain.RemarkType = Type::AnalysisAliasing;
+  Plain.PassName = "loop-vectorize";
+  Plain.RemarkName = "CantReorderMemOps";
+  Plain.FunctionName = "f";
+
+  std::vector<Remark> Remarks = {makeRemark("baz", 30), Plain,
+                                 makeRemark("qux", 0)};
+  std::string Buf = writeRemarks(Remarks);
+  EXPECT_TRUE(BinaryRemarkReader::isBinaryRemarks(Buf));
+
+  std::vector<std::string> Read = readRemarks(Buf);
+  ASSERT_EQ(Remarks.size(), Read.size());
+  for (size_t I = 0; I != Remarks.size(); ++I)
+    EXPECT_EQ(toYAML(Remarks[I]), Read[I]);
+
+  // Strings are only written once.
+  EXPECT_EQ(1U, StringRef(Buf).count("will not be inlined"));
+
+  // Concatenated files start over their string numbering.
+  std::vector<std::string> Twice = readRemarks(Buf + Buf);
+  ASSERT_EQ(2 * Remarks.size(), Twice.size());
+  for (size_t I = 0; I != Twice.size(); ++I)
+    EXPECT_EQ(Read[I % Remarks.size()], Twice[I]);
+}
+
+TEST(BinaryRemarksTest, Empty) {
+  std::string Buf = writeRemarks(None);
+  EXPECT_TRUE(readRemarks(Buf).empty());
+}
+
+TEST(BinaryRemarksTest, Malformed) {
+  EXPECT_EQ("malformed remarks at offset 0: not a binary remark file",
+            readError("--- !Passed\n"));
+  EXPECT_EQ("malformed remarks at offset 4: unsupported version 2",
+            readError(StringRef("RMRK\x02", 5)));
+
+  // Every truncation of a valid file fails cleanly, except the one that
+  // leaves only the header.
+  std::string Header = writeRemarks(None);
+  std::string Buf = writeRemarks(makeRemark("baz", 300));
+  for (size_t Size = 0; Size < Buf.size(); ++Size)
+    if (Size != Header.size())
+      EXPECT_NE("", readError(StringRef(Buf).take_front(Size)));
+
+  // A remark type past the last one.
+  std::string BadType = Header + "\x07";
+  EXPECT_EQ("malformed remarks at offset 5: invalid remark type 7",
+            readError(BadType));
+
+  // A reference to a string that was not defined.
+  // Passed, no flags, string 2.
+  std::string BadString = Header + std::string("\x00\x00\x04", 3);
+  EXPECT_EQ("malformed remarks at offset 7: invalid string number 2",
+            readError(BadString));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,204 @@
+//===- CacheIndexTest.cpp -------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/CacheIndex.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+class CacheIndexTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("cache-index-test", Dir));
+  }
+
+  void TearDown() override { sys::fs::remove_directories(Dir); }
+
+  std::unique_ptr<CacheIndex> open() {
+    Expected<std::unique_ptr<CacheIndex>> Index = CacheIndex::open(Dir);
+    EXPECT_TRUE(bool(Index));
+    if (!Index) {
+      consumeError(Index.takeError());
+      return nullptr;
+    }
+    return std::move(*Index);
+  }
+
+  /// Write the file for \p Key and tell \p Index about it.
+  void add(CacheIndex &Index, StringRef Key, unsigned Size) {
+    std::error_code EC;
+    raw_fd_ostream OS(Index.getEntryPath(Key), EC, sys::fs::F_None);
+    ASSERT_FALSE(EC);
+    OS << std::string(Size, 'x');
+    OS.close();
+    Index.insert(Key, Size);
+  }
+
+  bool exists(CacheIndex &Index, StringRef Key) {
+    return sys::fs::exists(Index.getEntryPath(Key));
+  }
+
+  void appendToLog(StringRef Text) {
+    SmallString<128> IndexPath(Dir);
+    sys::path::append(IndexPath, "llvmcache.index");
+    std::error_code EC;
+    raw_fd_ostream OS(IndexPath, EC, sys::fs::F_Append);
+    ASSERT_FALSE(EC);
+    OS << Text;
+  }
+
+  SmallString<128> Dir;
+};
+
+TEST_F(CacheIndexTest, LookupAndInsert) {
+  auto Index = open();
+  ASSERT_TRUE(Index);
+  EXPECT_FALSE(Index->lookup("a"));
+  add(*Index, "a", 10);
+  add(*Index, "b", 20);
+  EXPECT_TRUE(Index->lookup("a"));
+  EXPECT_TRUE(Index->lookup("b"));
+  EXPECT_TRUE(Index->lookup("a"));
+  EXPECT_FALSE(Index->lookup("c"));
+
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  EXPECT_EQ(2u, Stats.NumEntries);
+  EXPECT_EQ(30u, Stats.TotalSize);
+  EXPECT_EQ(3u, Stats.Hits);
+  EXPECT_EQ(2u, Stats.Misses);
+  EXPECT_EQ(0u, Stats.Evictions);
+}
+
+TEST_F(CacheIndexTest, Persistence) {
+  {
+    auto Index = open();
+    ASSERT_TRUE(Index);
+    add(*Index, "a", 10);
+    add(*Index, "b", 20);
+    add(*Index, "a", 15);
+    EXPECT_TRUE(Index->lookup("b"));
+  }
+
+  auto Index = open();
+  ASSERT_TRUE(Index);
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  EXPECT_EQ(2u, Stats.NumEntries);
+  EXPECT_EQ(35u, Stats.TotalSize);
+  EXPECT_EQ(1u, Stats.Hits);
+  EXPECT_EQ(3u, Stats.Misses);
+}
+
+TEST_F(CacheIndexTest, PruneLeastRecentlyUsed) {
+  auto Index = open();
+  ASSERT_TRUE(Index);
+  add(*Index, "a", 10);
+  add(*Index, "b", 10);
+  add(*Index, "c", 10);
+  add(*Index, "d", 10);
+  // Make "a" the most recently used entry.
+  EXPECT_TRUE(Index->lookup("a"));
+
+  CachePruningPolicy Policy;
+  Policy.Expiration = std::chrono::seconds(0);
+  Policy.MaxSizePercentageOfAvailableSpace = 0;
+  Policy.MaxSizeFiles = 3;
+  EXPECT_EQ(1u, Index->prune(Policy));
+  EXPECT_FALSE(exists(*Index, "b"));
+  EXPECT_FALSE(Index->lookup("b"));
+
+  Policy.MaxSizeFiles = 0;
+  Policy.MaxSizeBytes = 15;
+  EXPECT_EQ(2u, Index->prune(Policy));
+  EXPECT_FALSE(exists(*Index, "c"));
+  EXPECT_FALSE(exists(*Index, "d"));
+  EXPECT_TRUE(exists(*Index, "a"));
+
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  EXPECT_EQ(1u, Stats.NumEntries);
+  EXPECT_EQ(10u, Stats.TotalSize);
+  EXPECT_EQ(3u, Stats.Evictions);
+
+  // Nothing to do once the policy is satisfied.
+  EXPECT_EQ(0u, Index->prune(Policy));
+
+  // The evictions are in the log.
+  Index = open();
+  ASSERT_TRUE(Index);
+  Stats = Index->getStatistics();
+  EXPECT_EQ(1u, Stats.NumEntries);
+  EXPECT_EQ(3u, Stats.Evictions);
+  EXPECT_TRUE(Index->lookup("a"));
+}
+
+TEST_F(CacheIndexTest, Compact) {
+  auto Index = open();
+  ASSERT_TRUE(Index);
+  add(*Index, "a", 10);
+  add(*Index, "b", 20);
+  for (unsigned I = 0; I != 10; ++I)
+    EXPECT_TRUE(Index->lookup("a"));
+  ASSERT_FALSE(bool(Index->compact()));
+  add(*Index, "c", 30);
+
+  Index = open();
+  ASSERT_TRUE(Index);
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  EXPECT_EQ(3u, Stats.NumEntries);
+  EXPECT_EQ(60u, Stats.TotalSize);
+  EXPECT_EQ(10u, Stats.Hits);
+  EXPECT_EQ(3u, Stats.Misses);
+
+  // Compaction keeps the LRU order: "b" goes first.
+  CachePruningPolicy Policy;
+  Policy.Expiration = std::chrono::seconds(0);
+  Policy.MaxSizePercentageOfAvailableSpace = 0;
+  Policy.MaxSizeFiles = 2;
+  EXPECT_EQ(1u, Index->prune(Policy));
+  EXPECT_FALSE(exists(*Index, "b"));
+}
+
+TEST_F(CacheIndexTest, MalformedRecords) {
+  {
+    auto Index = open();
+    ASSERT_TRUE(Index);
+    add(*Index, "a", 10);
+  }
+  appendToLog("bogus\nA x 10 b\nH 1\nA 1 10 c");
+
+  auto Index = open();
+  ASSERT_TRUE(Index);
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  EXPECT_EQ(1u, Stats.NumEntries);
+  EXPECT_EQ(10u, Stats.TotalSize);
+  EXPECT_FALSE(Index->lookup("c"));
+}
+
+TEST_F(CacheIndexTest, AdoptEntries) {
+  auto Index = open();
+  ASSERT_TRUE(Index);
+
+  // An entry written by someone else is found on lookup.
+  auto Other = open();
+  ASSERT_TRUE(Other);
+  add(*Other, "a", 10);
+
+  EXPECT_TRUE(Index->lookup("a"));
+  CacheIndex::Statistics Stats = Index->getStatistics();
+  EXPECT_EQ(1u, Stats.NumEntries);
+  EXPECT_EQ(10u, Stats.TotalSize);
+  EXPECT_EQ(1u, Stats.Hits);
+}
+
+} // end anonymous namespace
@@ -74,4 +74,101 @@ TEST(CompressionTest, ZlibCRC32) {
 
 #endif
 
+TEST(CompressionTest, Formats) {
+  EXPECT_EQ("zlib", compression::getName(compression::Format::Zlib));
+  EXPECT_EQ("zstd", compression::getName(compression::Format::Zstd));
+  EXPECT_EQ("lz4", compression::getName(compression::Format::LZ4));
+  EXPECT_EQ(zlib::isAvailable(),
+            compression::isAvailable(compression::Format::Zlib));
+  EXPECT_EQ(zstd::isAvailable(),
+            compression::isAvailable(compression::Format::Zstd));
+  EXPECT_EQ(lz4::isAvailable(),
+            compression::isAvailable(compression::Format::LZ4));
+}
+
+#if (LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ) || LLVM_ENABLE_ZSTD || LLVM_ENABLE_LZ4
+
+void TestCompression(compression::Format F, StringRef Input,
+                     compression::CompressionLevel Level, size_t ChunkSize) {
+  SmallString<32> Compressed;
+  SmallString<32> Uncompressed;
+
+  Error E = compression::compressParallel(F, Input, Compressed, Level,
+                                          ChunkSize);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+
+  E = compression::uncompress(F, Compressed, Uncompressed, Input.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+  EXPECT_EQ(Input, Uncompressed);
+
+  if (Input.size() > 0) {
+    // Uncompression fails if expected length is too short.
+    E = compression::uncompress(F, Compressed, Uncompressed,
+                                Input.size() - 1);
+    EXPECT_TRUE(bool(E));
+    consumeError(std::move(E));
+  }
+}
+
+void TestFormat(compression::Format F) {
+  std::string Data;
+  for (unsigned I = 0; I != 10000; ++I)
+    Data += "line " + std::to_string(I % 97) + "\n";
+
+  for (compression::CompressionLevel Level :
+       {compression::NoCompression, compression::BestSpeedCompression,
+        compression::DefaultCompression, compression::BestSizeCompression}) {
+    TestCompression(F, "", Level, 1 << 20);
+    TestCompression(F, "hello, world!", Level, 1 << 20);
+    // One chunk, then many chunks with a short last one.
+    TestCompression(F, Data, Level, 1 << 20);
+    TestCompression(F, Data, Level, 1000);
+  }
+
+  // Output that fits in one chunk is the same as that of compress.
+  SmallString<32> Serial;
+  SmallString<32> Parallel;
+  EXPECT_FALSE(compression::compress(F, Data, Serial));
+  EXPECT_FALSE(compression::compressParallel(F, Data, Parallel));
+  EXPECT_EQ(Serial, Parallel);
+}
+
+#endif
+
+#if LLVM_ENABLE_ZLIB == 1 && HAVE_LIBZ
+
+TEST(CompressionTest, ZlibFormat) { TestFormat(compression::Format::Zlib); }
+
+TEST(CompressionTest, ZlibParallelIsOneStream) {
+  std::string Data(100000, 'a');
+  for (size_t I = 0; I < Data.size(); I += 7)
+    Data[I] = 'a' + I % 26;
+
+  // The chunks form one zlib stream, so zlib::uncompress takes it as is.
+  SmallString<32> Compressed;
+  SmallString<32> Uncompressed;
+  EXPECT_FALSE(compression::compressParallel(compression::Format::Zlib, Data,
+                                             Compressed,
+                                             compression::DefaultCompression,
+                                             4096));
+  EXPECT_FALSE(zlib::uncompress(Compressed, Uncompressed, Data.size()));
+  EXPECT_EQ(Data, Uncompressed);
+}
+
+#endif
+
+#if LLVM_ENABLE_ZSTD
+
+TEST(CompressionTest, ZstdFormat) { TestFormat(compression::Format::Zstd); }
+
+#endif
+
+#if LLVM_ENABLE_LZ4
+
+TEST(CompressionTest, LZ4Format) { TestFormat(compression::Format::LZ4); }
+
+#endif
+
 }
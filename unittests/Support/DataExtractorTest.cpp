@@ -117,4 +117,37 @@ TEST(DataExtractorTest, LEB128) {
   EXPECT_EQ(8U, offset);
 }
 
+TEST(DataExtractorTest, LEB128Array) {
+  DataExtractor DE(StringRef(bigleb128data, sizeof(bigleb128data)-1), false, 8);
+  uint32_t offset = 0;
+  uint64_t uvalues[3];
+  DE.getULEB128(&offset, uvalues, 3);
+  EXPECT_EQ(42218325750568106ULL, uvalues[0]);
+  EXPECT_EQ(0ULL, uvalues[1]);
+  EXPECT_EQ(0ULL, uvalues[2]);
+  EXPECT_EQ(8U, offset);
+
+  // Behave like getULEB128() and getSLEB128() when running off the end.
+  const char data[] = "\x01\x7f\x80\x01\xff\xff";
+  DataExtractor TDE(StringRef(data, sizeof(data)-1), false, 8);
+  offset = 0;
+  TDE.getULEB128(&offset, uvalues, 3);
+  EXPECT_EQ(1ULL, uvalues[0]);
+  EXPECT_EQ(0x7fULL, uvalues[1]);
+  EXPECT_EQ(0x80ULL, uvalues[2]);
+  EXPECT_EQ(4U, offset);
+  TDE.getULEB128(&offset, uvalues, 2);
+  EXPECT_EQ(0x3fffULL, uvalues[0]);
+  EXPECT_EQ(0ULL, uvalues[1]);
+  EXPECT_EQ(6U, offset);
+
+  int64_t svalues[3];
+  offset = 0;
+  TDE.getSLEB128(&offset, svalues, 3);
+  EXPECT_EQ(1LL, svalues[0]);
+  EXPECT_EQ(-1LL, svalues[1]);
+  EXPECT_EQ(128LL, svalues[2]);
+  EXPECT_EQ(4U, offset);
+}
+
 }
@@ -11,7 +11,10 @@
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
+#include <chrono>
+#include <random>
 #include <string>
+#include <vector>
 using namespace llvm;
 
 namespace {
@@ -175,6 +178,129 @@ TEST(LEB128Test, DecodeSLEB128) {
 #undef EXPECT_DECODE_SLEB128_EQ
 }
 
+// Encode Values, mostly one-byte ones with multi-byte ones sprinkled in, to
+// exercise both the bulk and the scalar paths of the array decoders.
+static std::vector<uint8_t> encodeValues(const std::vector<int64_t> &Values,
+                                         bool Signed) {
+  std::vector<uint8_t> Bytes;
+  uint8_t Buffer[16];
+  for (int64_t V : Values) {
+    unsigned Size =
+        Signed ? encodeSLEB128(V, Buffer) : encodeULEB128(V, Buffer);
+    Bytes.insert(Bytes.end(), Buffer, Buffer + Size);
+  }
+  return Bytes;
+}
+
+static std::vector<int64_t> makeValues(size_t Count, bool Signed,
+                                       unsigned LongEvery) {
+  std::mt19937_64 Rand(Count);
+  std::vector<int64_t> Values;
+  for (size_t I = 0; I != Count; ++I) {
+    uint64_t V = Rand();
+    if (I % LongEvery != LongEvery - 1)
+      V &= Signed ? 0x3f : 0x7f;
+    else
+      V >>= Rand() % 64;
+    if (Signed && (Rand() & 1))
+      V = -V;
+    Values.push_back(V);
+  }
+  return Values;
+}
+
+TEST(LEB128Test, DecodeULEB128Array) {
+  for (unsigned LongEvery : {1, 3, 17, 1000})
+    for (size_t Count : {0, 1, 7, 8, 15, 16, 31, 32, 33, 100, 1000}) {
+      std::vector<int64_t> Values = makeValues(Count, false, LongEvery);
+      std::vector<uint8_t> Bytes = encodeValues(Values, false);
+      std::vector<uint64_t> Out(Count + 1, 0xdead);
+      size_t Size = 0;
+      const char *Error = "not set";
+      EXPECT_EQ(Count, decodeULEB128Array(Bytes.data(),
+                                          Bytes.data() + Bytes.size(),
+                                          Out.data(), Count, &Size, &Error));
+      EXPECT_EQ(Bytes.size(), Size);
+      EXPECT_EQ(nullptr, Error);
+      for (size_t I = 0; I != Count; ++I)
+        EXPECT_EQ(uint64_t(Values[I]), Out[I]);
+      EXPECT_EQ(0xdeadu, Out[Count]);
+    }
+
+  // Stop at a value that runs off the end, or that doesn't fit in 64 bits.
+  const uint8_t Truncated[] = {1, 2, 3, 0x80, 0x80};
+  uint64_t Out[4];
+  size_t Size = 0;
+  const char *Error = nullptr;
+  EXPECT_EQ(3u, decodeULEB128Array(Truncated, std::end(Truncated), Out, 4,
+                                   &Size, &Error));
+  EXPECT_EQ(3u, Size);
+  EXPECT_STREQ("malformed uleb128, extends past end", Error);
+
+  std::vector<uint8_t> TooBig(40, 0);
+  std::fill(TooBig.begin() + 20, TooBig.begin() + 31, 0xff);
+  std::vector<uint64_t> Values(21);
+  EXPECT_EQ(20u, decodeULEB128Array(TooBig.data(), TooBig.data() + 40,
+                                    Values.data(), 21, &Size, &Error));
+  EXPECT_EQ(20u, Size);
+  EXPECT_STREQ("uleb128 too big for uint64", Error);
+}
+
+TEST(LEB128Test, DecodeSLEB128Array) {
+  for (unsigned LongEvery : {1, 3, 17, 1000})
+    for (size_t Count : {0, 1, 7, 8, 15, 16, 31, 32, 33, 100, 1000}) {
+      std::vector<int64_t> Values = makeValues(Count, true, LongEvery);
+      std::vector<uint8_t> Bytes = encodeValues(Values, true);
+      std::vector<int64_t> Out(Count);
+      size_t Size = 0;
+      EXPECT_EQ(Count, decodeSLEB128Array(Bytes.data(),
+                                          Bytes.data() + Bytes.size(),
+                                          Out.data(), Count, &Size));
+      EXPECT_EQ(Bytes.size(), Size);
+      EXPECT_EQ(Values, Out);
+    }
+
+  // The most negative value takes 10 bytes.
+  std::vector<int64_t> Values(40, -1);
+  Values[20] = INT64_MIN;
+  std::vector<uint8_t> Bytes = encodeValues(Values, true);
+  std::vector<int64_t> Out(40);
+  EXPECT_EQ(40u, decodeSLEB128Array(Bytes.data(), Bytes.data() + Bytes.size(),
+                                    Out.data(), 40));
+  EXPECT_EQ(Values, Out);
+}
+
+// Compare the array decoder with decoding the values one at a time.
+TEST(LEB128Test, DecodeULEB128ArrayThroughput) {
+  const size_t Count = 1 << 20;
+  std::vector<int64_t> Values = makeValues(Count, false, 20);
+  std::vector<uint8_t> Bytes = encodeValues(Values, false);
+  std::vector<uint64_t> Out(Count);
+  typedef std::chrono::steady_clock Clock;
+
+  Clock::time_point Start = Clock::now();
+  const uint8_t *P = Bytes.data();
+  for (size_t I = 0; I != Count; ++I) {
+    unsigned Size;
+    Out[I] = decodeULEB128(P, &Size);
+    P += Size;
+  }
+  Clock::time_point Mid = Clock::now();
+  EXPECT_EQ(Count, decodeULEB128Array(Bytes.data(), Bytes.data() + Bytes.size(),
+                                      Out.data(), Count));
+  Clock::time_point End = Clock::now();
+  EXPECT_EQ(uint64_t(Values.back()), Out.back());
+
+  // Report the times in the test's XML output.
+  typedef std::chrono::microseconds US;
+  testing::Test::RecordProperty(
+      "ScalarMicroseconds",
+      int(std::chrono::duration_cast<US>(Mid - Start).count()));
+  testing::Test::RecordProperty(
+      "ArrayMicroseconds",
+      int(std::chrono::duration_cast<US>(End - Mid).count()));
+}
+
 TEST(LEB128Test, SLEB128Size) {
   // Positive Value Testing Plan:
   // (1) 128 ^ n - 1 ........ need (n+1) bytes
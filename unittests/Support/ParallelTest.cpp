@@ -15,6 +15,8 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
+#include <functional>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -50,4 +52,33 @@ TEST(Parallel, parallel_for) {
   ASSERT_EQ(range[2049], 1u);
 }
 
+TEST(Parallel, NestedTaskGroup) {
+  // Every task forks subtasks and waits for them. Workers waiting on their
+  // children must keep running queued tasks or the pool would deadlock.
+  std::atomic<unsigned> Count{0};
+  std::function<void(unsigned)> Fork = [&](unsigned Depth) {
+    ++Count;
+    if (Depth == 0)
+      return;
+    parallel::detail::TaskGroup TG;
+    for (unsigned I = 0; I != 4; ++I)
+      TG.spawn([&, Depth] { Fork(Depth - 1); });
+    TG.sync();
+  };
+  Fork(6);
+  // 1 + 4 + 4^2 + ... + 4^6
+  ASSERT_EQ(5461u, Count.load());
+}
+
+TEST(Parallel, NestedForEach) {
+  uint32_t Sums[64] = {};
+  for_each_n(parallel::par, 0, 64, [&](size_t I) {
+    std::atomic<uint32_t> Sum{0};
+    for_each_n(parallel::par, 0, 2048, [&](size_t J) { Sum += J; });
+    Sums[I] = Sum;
+  });
+  for (uint32_t Sum : Sums)
+    ASSERT_EQ(2048u * 2047u / 2, Sum);
+}
+
 #endif
@@ -147,6 +147,22 @@ TEST_F(ThreadPoolTest, GetFuture) {
   ASSERT_EQ(2, i.load());
 }
 
+TEST_F(ThreadPoolTest, NestedAsync) {
+  CHECK_UNSUPPORTED();
+  // Tasks submitting tasks to their own pool are waited for by wait().
+  std::atomic_int checked_in{0};
+  ThreadPool Pool{2};
+  for (size_t i = 0; i < 5; ++i) {
+    Pool.async([&Pool, &checked_in] {
+      for (size_t j = 0; j < 5; ++j)
+        Pool.async([&checked_in] { ++checked_in; });
+      ++checked_in;
+    });
+  }
+  Pool.wait();
+  ASSERT_EQ(30, checked_in);
+}
+
 TEST_F(ThreadPoolTest, PoolDestruction) {
   CHECK_UNSUPPORTED();
   // Test that we are waiting on destruction